@@ -0,0 +1,124 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Bridge_bench.cpp
+//    Description: Cost of crossing between OwningResult, std::expected and exceptions
+//    =================================
+
+#include "Bridge.hpp"
+#include "bench.hpp"
+
+#include <stdexcept>
+#include <string>
+
+constexpr std::size_t iterations = 1 << 20;
+
+// Large enough to live on the heap, so an accidental copy shows up as an extra allocation
+const std::string payload(64, 'x');
+
+[[gnu::noinline]] int parse_or_throw(std::size_t i)
+{
+	if (i == static_cast<std::size_t>(-1)) throw std::invalid_argument("never");
+	return static_cast<int>(i);
+}
+
+[[gnu::noinline]] int always_throw(std::size_t) { throw std::invalid_argument("bad input"); }
+
+int main()
+{
+	report("baseline: OwningResult<string> construct + unwrap",
+		   time_per_iteration(iterations, [](std::size_t) {
+			   OwningResult<std::string, int> result = OwningOk<std::string>(std::string(payload));
+			   do_not_optimize(result.unwrap());
+		   }));
+
+#ifdef OL_HAS_EXPECTED
+	report("baseline: std::expected<string> construct + value",
+		   time_per_iteration(iterations, [](std::size_t) {
+			   std::expected<std::string, int> expected(std::string{ payload });
+			   do_not_optimize(std::move(*expected));
+		   }));
+
+	report("to_expected (Ok)",
+		   time_per_iteration(iterations, [](std::size_t) {
+			   OwningResult<std::string, int> result = OwningOk<std::string>(std::string(payload));
+			   do_not_optimize(to_expected(std::move(result)));
+		   }));
+
+	report("to_expected (Err)",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   OwningResult<std::string, int> result = OwningErr<int>(static_cast<int>(i));
+			   do_not_optimize(to_expected(std::move(result)));
+		   }));
+
+	report("from_expected (Ok) + unwrap",
+		   time_per_iteration(iterations, [](std::size_t) {
+			   std::expected<std::string, int> expected(std::string{ payload });
+			   do_not_optimize(from_expected(std::move(expected)).unwrap());
+		   }));
+
+	report("from_expected (Err)",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   std::expected<std::string, int> expected = std::unexpected(static_cast<int>(i));
+			   do_not_optimize(from_expected(std::move(expected)).is_err());
+		   }));
+#else
+	std::cout << "std::expected is not available, skipping to_expected/from_expected\n";
+#endif
+
+	report("direct call, no bridge",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   do_not_optimize(parse_or_throw(i));
+		   }));
+
+	report("try_invoke, nothing thrown",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   do_not_optimize(try_invoke([i]() { return parse_or_throw(i); }).is_ok());
+		   }));
+
+	report("try_invoke with mapper, nothing thrown",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   auto result = try_invoke([i]() { return parse_or_throw(i); },
+										[](const std::exception&) { return -1; });
+			   do_not_optimize(result.is_ok());
+		   }));
+
+	report("try_invoke, exception thrown",
+		   time_per_iteration(iterations / 16, [](std::size_t i) {
+			   do_not_optimize(try_invoke([i]() { return always_throw(i); }).is_err());
+		   }));
+
+	report("or_throw (Ok)",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   OwningResult<int, int> result = OwningOk<int>(static_cast<int>(i));
+			   do_not_optimize(or_throw(std::move(result)));
+		   }));
+
+	report("or_throw (Err) + catch",
+		   time_per_iteration(iterations / 16, [](std::size_t i) {
+			   OwningResult<int, int> result = OwningErr<int>(static_cast<int>(i));
+			   try
+			   {
+				   do_not_optimize(or_throw(std::move(result)));
+			   }
+			   catch (BadResultAccess<int>& exception)
+			   {
+				   do_not_optimize(exception.error());
+			   }
+		   }));
+	return 0;
+}
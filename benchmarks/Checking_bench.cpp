@@ -0,0 +1,128 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Checking_bench.cpp
+//    Description: Per access cost of the full, light and no checking policies
+//    =================================
+
+#include "Result.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr std::size_t num_results = 1 << 16;
+constexpr std::size_t passes	  = 2000;
+
+template<typename Checking>
+using Boxed = OwningResult<std::uint64_t, std::uint64_t, OkLikely, Checking>;
+
+template<typename Checking>
+using Inline = OwningResult<std::uint64_t, void, OkLikely, Checking>;
+
+template<typename Checking>
+constexpr const char* policy_name(void)
+{
+	if constexpr (std::is_same_v<Checking, FullChecks>) return "full";
+	else if constexpr (std::is_same_v<Checking, LightChecks>) return "light";
+	else return "none";
+}
+
+template<typename Checking>
+std::vector<Boxed<Checking>> make_results(bool ok)
+{
+	std::vector<Boxed<Checking>> results;
+	results.reserve(num_results);
+	for (std::size_t i = 0; i < num_results; ++i)
+	{
+		if (ok) results.emplace_back(OwningOk<std::uint64_t>(std::uint64_t{ i }));
+		else results.emplace_back(OwningErr<std::uint64_t>(std::uint64_t{ i }));
+	}
+	return results;
+}
+
+template<typename Checking>
+void bench_policy(void)
+{
+	std::string suffix = std::string(" (") + policy_name<Checking>() + ")";
+	double		items  = static_cast<double>(num_results);
+
+	// err() on Ok results and ok() on Err results test the flags without consuming anything
+	auto oks = make_results<Checking>(true);
+	report("  err() on Ok results" + suffix,
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  std::uint64_t sum = 0;
+								  for (auto& result : oks)
+									  sum += result.err().value_or(1);
+								  do_not_optimize(sum);
+							  }),
+		   items);
+
+	auto errs = make_results<Checking>(false);
+	report("  ok() on Err results" + suffix,
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  std::uint64_t sum = 0;
+								  for (auto& result : errs)
+									  sum += result.ok().value_or(1);
+								  do_not_optimize(sum);
+							  }),
+		   items);
+
+	// unwrap on inline results, where no allocation hides the check
+	report("  construct + unwrap, inline value" + suffix,
+		   time_per_iteration(passes,
+							  [&](std::size_t pass) {
+								  std::uint64_t sum = 0;
+								  for (std::size_t i = 0; i < num_results; ++i)
+								  {
+									  Inline<Checking> result(std::uint64_t{ i ^ pass });
+									  do_not_optimize(result);
+									  sum += result.unwrap();
+								  }
+								  do_not_optimize(sum);
+							  }),
+		   items);
+
+	// unwrap on boxed results. Once inlined the compiler may elide the box altogether
+	report("  construct + unwrap, boxed value" + suffix,
+		   time_per_iteration(passes / 20,
+							  [&](std::size_t pass) {
+								  std::uint64_t sum = 0;
+								  for (std::size_t i = 0; i < num_results; ++i)
+								  {
+									  Boxed<Checking> result = OwningOk<std::uint64_t>(i ^ pass);
+									  sum += result.unwrap();
+								  }
+								  do_not_optimize(sum);
+							  }),
+		   items);
+}
+
+int main()
+{
+	std::cout << "sizeof OwningResult<uint64_t, uint64_t>: full "
+			  << sizeof(Boxed<FullChecks>) << ", light " << sizeof(Boxed<LightChecks>)
+			  << ", none " << sizeof(Boxed<NoChecks>) << "\n";
+	bench_policy<FullChecks>();
+	bench_policy<LightChecks>();
+	bench_policy<NoChecks>();
+	return 0;
+}
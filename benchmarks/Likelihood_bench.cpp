@@ -0,0 +1,128 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Likelihood_bench.cpp
+//    Description: Consumes results with skewed error rates under each likelihood policy
+//    =================================
+
+#include "Result.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr std::size_t num_results = 1 << 16;
+constexpr std::size_t passes	  = 64;
+
+template<typename Policy>
+using Result = OwningResult<std::uint64_t, std::uint64_t, Policy>;
+
+template<typename Policy>
+constexpr std::string_view policy_name(void)
+{
+	if constexpr (std::is_same_v<Policy, OkLikely>) return "OkLikely";
+	else if constexpr (std::is_same_v<Policy, ErrLikely>) return "ErrLikely";
+	else return "Neutral";
+}
+
+// Stands in for real error handling: logging, formatting a message, falling back
+[[gnu::noinline]] std::uint64_t handle_error(std::uint64_t code)
+{
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (int i = 0; i < 8; ++i)
+		hash = (hash ^ ((code >> (i * 8)) & 0xff)) * 1099511628211ULL;
+	return hash;
+}
+
+// Errors are scattered with an LCG so the pattern cannot be learned from the index
+template<typename Policy>
+std::vector<Result<Policy>> make_results(double error_rate)
+{
+	std::vector<Result<Policy>> results;
+	results.reserve(num_results);
+	std::uint64_t state		= 88172645463325252ULL;
+	auto		  threshold = static_cast<std::uint64_t>(error_rate * 18446744073709551615.0);
+	for (std::size_t i = 0; i < num_results; ++i)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		if (state < threshold) results.push_back(OwningErr<std::uint64_t>(std::uint64_t{ i }));
+		else results.push_back(OwningOk<std::uint64_t>(std::uint64_t{ i }));
+	}
+	return results;
+}
+
+// The plain branch: is_ok() chooses between the inline Ok path and the error handler
+template<typename Policy>
+std::uint64_t consume_branch(const std::vector<Result<Policy>>& results)
+{
+	std::uint64_t sum = 0;
+	for (const auto& result : results)
+	{
+		if (result.is_ok()) sum += *result.peek_ok();
+		else sum += handle_error(*result.peek_err());
+	}
+	return sum;
+}
+
+// The combinator: map_or_else runs the unlikely side through a cold trampoline
+template<typename Policy>
+std::uint64_t consume_combinator(std::vector<Result<Policy>>& results)
+{
+	std::uint64_t sum = 0;
+	for (auto& result : results)
+		sum += result.template map_or_else<std::uint64_t>(
+			[](std::uint64_t& code) { return handle_error(code); },
+			[](std::uint64_t& value) { return value; });
+	return sum;
+}
+
+template<typename Policy>
+void bench_policy(double error_rate, BranchMissCounter& misses)
+{
+	auto		results = make_results<Policy>(error_rate);
+	std::string suffix	= std::string(" ") + std::string(policy_name<Policy>());
+	double		items	= static_cast<double>(num_results);
+
+	report("  is_ok branch" + suffix,
+		   time_per_iteration(passes, [&](std::size_t) { do_not_optimize(consume_branch(results)); }),
+		   items);
+	report("  map_or_else" + suffix,
+		   time_per_iteration(passes,
+							  [&](std::size_t) { do_not_optimize(consume_combinator(results)); }),
+		   items);
+
+	if (auto count = misses.measure([&]() { do_not_optimize(consume_branch(results)); }))
+		std::cout << "    branch misses per result: "
+				  << static_cast<double>(*count) / static_cast<double>(num_results) << "\n";
+}
+
+int main()
+{
+	BranchMissCounter misses;
+	if (!misses.available())
+		std::cout << "Branch miss counter unavailable (perf_event_open failed), timing only\n";
+
+	for (double error_rate : { 0.0, 0.001, 0.01, 0.1, 0.5, 0.9, 0.99 })
+	{
+		std::cout << "error rate " << error_rate * 100.0 << "%\n";
+		bench_policy<OkLikely>(error_rate, misses);
+		bench_policy<ErrLikely>(error_rate, misses);
+		bench_policy<Neutral>(error_rate, misses);
+	}
+	return 0;
+}
@@ -0,0 +1,147 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: MappedFile_bench.cpp
+//    Description: Reading lines and fixed size records of a large file through MappedFile,
+//                 against std::ifstream with std::getline and read
+//    =================================
+//
+//    Usage: MappedFile_bench.x [file size in MiB, default 1024]
+
+#include "MappedFile.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+constexpr std::size_t record_size = 128;
+
+// Lines between 1 and 160 bytes, about 80 on average
+std::uint64_t write_input(const std::filesystem::path& path, std::uint64_t bytes)
+{
+	std::ofstream out(path, std::ios::binary);
+	std::string	  line;
+	std::uint64_t state	  = 0x9E3779B97F4A7C15ULL;
+	std::uint64_t written = 0;
+	std::uint64_t lines	  = 0;
+	for (; written < bytes; ++lines)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		line.assign(1 + (state >> 33) % 160, static_cast<char>('a' + lines % 26));
+		line += '\n';
+		out.write(line.data(), static_cast<std::streamsize>(line.size()));
+		written += line.size();
+	}
+	return lines;
+}
+
+// Every variant computes the same checksum: number of bytes plus the first byte of each line
+std::uint64_t checksum_getline(const std::filesystem::path& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	std::string	  line;
+	std::uint64_t sum = 0;
+	while (std::getline(in, line))
+		sum += line.size() + static_cast<unsigned char>(line.empty() ? 0 : line.front());
+	return sum;
+}
+
+std::uint64_t checksum_mapped_lines(const std::filesystem::path& path, MapOptions options)
+{
+	MappedFile	  file = MappedFile::open(path, options).unwrap();
+	std::uint64_t sum  = 0;
+	for (auto result : file.lines())
+	{
+		std::string_view line = result.unwrap();
+		sum += line.size() + static_cast<unsigned char>(line.empty() ? 0 : line.front());
+	}
+	return sum;
+}
+
+std::uint64_t checksum_read_records(const std::filesystem::path& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	char		  record[record_size];
+	std::uint64_t sum = 0;
+	while (in.read(record, record_size))
+		sum += static_cast<unsigned char>(record[0]) + static_cast<unsigned char>(record[100]);
+	return sum;
+}
+
+std::uint64_t checksum_mapped_records(const std::filesystem::path& path)
+{
+	MappedFile	  file = MappedFile::open(path).unwrap();
+	std::uint64_t sum  = 0;
+	for (auto result : file.records(record_size))
+		if (const std::string_view* record = result.peek_ok())
+			sum += static_cast<unsigned char>((*record)[0])
+				 + static_cast<unsigned char>((*record)[100]);
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	std::uint64_t mib	  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+	TempFile	  input{ "MappedFile_bench" };
+	const auto&	  path	  = input.path();
+	double		  lines	  = static_cast<double>(write_input(path, mib << 20));
+	double		  records = static_cast<double>(std::filesystem::file_size(path) / record_size);
+	std::cout << "input: " << mib << " MiB, " << static_cast<std::uint64_t>(lines)
+			  << " lines, page cache warm\n";
+
+	// One untimed pass so every variant reads from the page cache
+	std::uint64_t expected = checksum_getline(path);
+	if (checksum_mapped_lines(path, MapOptions{}) != expected)
+		std::cout << "checksum mismatch between getline and MappedFile\n";
+
+	report("ifstream + getline",
+		   time_per_iteration(1, [&](std::size_t) { do_not_optimize(checksum_getline(path)); }),
+		   lines);
+	report("MappedFile lines, sequential",
+		   time_per_iteration(
+			   1,
+			   [&](std::size_t) { do_not_optimize(checksum_mapped_lines(path, MapOptions{})); }),
+		   lines);
+	report("MappedFile lines, sequential + huge pages",
+		   time_per_iteration(1,
+							  [&](std::size_t) {
+								  do_not_optimize(
+									  checksum_mapped_lines(path, MapOptions{ true, true }));
+							  }),
+		   lines);
+	report("MappedFile lines, no hints",
+		   time_per_iteration(1,
+							  [&](std::size_t) {
+								  do_not_optimize(
+									  checksum_mapped_lines(path, MapOptions{ false, false }));
+							  }),
+		   lines);
+	report("ifstream read, 128 byte records",
+		   time_per_iteration(1,
+							  [&](std::size_t) { do_not_optimize(checksum_read_records(path)); }),
+		   records);
+	report("MappedFile records, 128 bytes",
+		   time_per_iteration(
+			   1, [&](std::size_t) { do_not_optimize(checksum_mapped_records(path)); }),
+		   records);
+
+	return 0;
+}
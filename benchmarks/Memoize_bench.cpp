@@ -0,0 +1,134 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Memoize_bench.cpp
+//    Description: Throughput of memoized lookups under zipfian key distributions, with and
+//                 without negative caching
+//    =================================
+
+#include "Memoize.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Key	 = std::uint32_t;
+using Lookup = OwningResult<std::uint64_t, int>;
+
+constexpr std::size_t num_keys		   = 100000;
+constexpr std::size_t calls_per_thread = 1 << 18;
+
+// A few microseconds of work, one key in twenty fails
+Lookup expensive_lookup(const Key& key)
+{
+	std::uint64_t seed = key;
+	for (int i = 0; i < 2000; ++i)
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	if (key % 20 == 0) return OwningErr<int>(static_cast<int>(key));
+	return OwningOk<std::uint64_t>(std::uint64_t{ seed });
+}
+
+// Keys are drawn up front so only the lookups are timed
+std::vector<Key> zipfian_keys(std::size_t count, double skew, std::uint32_t seed)
+{
+	std::vector<double> cdf(num_keys);
+	double				sum = 0.0;
+	for (std::size_t rank = 0; rank < num_keys; ++rank)
+		cdf[rank] = sum += 1.0 / std::pow(static_cast<double>(rank + 1), skew);
+
+	std::mt19937_64						   engine(seed);
+	std::uniform_real_distribution<double> uniform(0.0, sum);
+	std::vector<Key>					   keys(count);
+	for (Key& key : keys)
+	{
+		auto rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(engine)) - cdf.begin();
+		// Scatter the ranks so popular keys do not share a shard
+		key = static_cast<Key>((static_cast<std::uint64_t>(rank) * 2654435761ULL) % num_keys);
+	}
+	return keys;
+}
+
+template<typename Func>
+double run_threads(std::size_t num_threads, const std::vector<std::vector<Key>>& keys, Func&& func)
+{
+	return time_per_iteration(1, [&](std::size_t) {
+		std::vector<std::thread> threads;
+		for (std::size_t t = 0; t < num_threads; ++t)
+			threads.emplace_back([&, t]() {
+				std::uint64_t sum = 0;
+				for (Key key : keys[t])
+					sum += func(key);
+				do_not_optimize(sum);
+			});
+		for (auto& thread : threads)
+			thread.join();
+	});
+}
+
+void bench(double skew, std::size_t num_threads)
+{
+	std::vector<std::vector<Key>> keys;
+	for (std::size_t t = 0; t < num_threads; ++t)
+		keys.push_back(zipfian_keys(calls_per_thread, skew, static_cast<std::uint32_t>(t + 1)));
+	double		items  = static_cast<double>(calls_per_thread * num_threads);
+	std::string suffix = " skew=" + std::to_string(skew).substr(0, 4)
+					   + " threads=" + std::to_string(num_threads);
+
+	report("uncached" + suffix,
+		   run_threads(num_threads,
+					   keys,
+					   [](Key key) { return expensive_lookup(key).is_ok() ? 1u : 0u; }),
+		   items);
+
+	for (std::size_t err_capacity : { std::size_t{ 0 }, std::size_t{ 4096 } })
+	{
+		MemoizeConfig config;
+		config.ok_capacity	= 16384;
+		config.err_capacity = err_capacity;
+		config.err_ttl		= std::chrono::seconds(10);
+		auto cached			= memoize<Key, std::uint64_t, int>(expensive_lookup, config);
+
+		std::string name = err_capacity == 0 ? "memoize, no negative cache" : "memoize";
+		report(name + suffix,
+			   run_threads(num_threads, keys, [&cached](Key key) {
+				   return cached(key).is_ok() ? 1u : 0u;
+			   }),
+			   items);
+		MemoizeStats stats = cached.stats();
+		double		 total = static_cast<double>(stats.hits + stats.negative_hits + stats.misses
+											+ stats.coalesced);
+		std::cout << "    hit ratio " << static_cast<double>(stats.hits) / total
+				  << ", negative hit ratio " << static_cast<double>(stats.negative_hits) / total
+				  << ", evictions " << stats.evictions << "\n";
+	}
+}
+
+int main()
+{
+	std::size_t hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	for (double skew : { 0.8, 0.99, 1.2 })
+	{
+		bench(skew, 1);
+		if (hardware > 1) bench(skew, hardware);
+	}
+	return 0;
+}
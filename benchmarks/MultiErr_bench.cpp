@@ -0,0 +1,121 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: MultiErr_bench.cpp
+//    Description: Validation of a 10k field message collecting every error, MultiErr against a
+//                 vector of boxed errors
+//    =================================
+
+#include "MultiErr.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr std::size_t num_fields = 10000;
+constexpr std::size_t passes	 = 200;
+
+struct FieldError {
+	std::uint32_t field;
+	std::uint32_t code;
+};
+
+using FieldStatus = OwningResult<void, FieldError>;
+
+// A field is invalid when its value is negative
+[[gnu::noinline]] FieldStatus validate_field(const std::int32_t& value)
+{
+	if (value < 0) [[unlikely]]
+		return FieldError{ static_cast<std::uint32_t>(-value), 7 };
+	return OwningOk<void>();
+}
+
+std::vector<std::int32_t> make_message(std::size_t invalid_every)
+{
+	std::vector<std::int32_t> fields(num_fields);
+	for (std::size_t i = 0; i < num_fields; ++i)
+		fields[i] = static_cast<std::int32_t>(i + 1);
+	if (invalid_every > 0)
+		for (std::size_t i = 0; i < num_fields; i += invalid_every)
+			fields[i] = -fields[i];
+	return fields;
+}
+
+// What batch validation did before MultiErr: every error boxed in its own OwningErr
+std::size_t validate_vector(const std::vector<std::int32_t>& fields)
+{
+	std::vector<OwningErr<FieldError>> errors;
+	for (const std::int32_t& field : fields)
+	{
+		FieldStatus status = validate_field(field);
+		if (status.is_err()) errors.push_back(OwningErr<FieldError>(*status.err()));
+	}
+	return errors.size();
+}
+
+template<std::size_t N>
+std::size_t validate_multi(const std::vector<std::int32_t>& fields,
+						   std::pmr::memory_resource*		arena)
+{
+	auto status = validate_all<N>(fields, validate_field, arena);
+	return status.is_ok() ? 0 : status.peek_err()->total();
+}
+
+void bench_batch(const std::string& name, std::size_t invalid_every)
+{
+	std::vector<std::int32_t> fields = make_message(invalid_every);
+	double					  items	 = static_cast<double>(num_fields);
+	std::cout << name << "\n";
+
+	report("  vector<OwningErr<E>>",
+		   time_per_iteration(passes,
+							  [&](std::size_t) { do_not_optimize(validate_vector(fields)); }),
+		   items);
+	report("  MultiErr<E, 16>, overflow counted",
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  do_not_optimize(validate_multi<16>(fields, nullptr));
+							  }),
+		   items);
+	report("  MultiErr<E, 16>, heap arena",
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  do_not_optimize(
+									  validate_multi<16>(fields, std::pmr::new_delete_resource()));
+							  }),
+		   items);
+
+	// The arena's buffer is reused by every batch, as a server would reuse it per message
+	std::vector<std::byte>				buffer(num_fields * sizeof(FieldError) * 4);
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+	report("  MultiErr<E, 16>, reused monotonic arena",
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  do_not_optimize(validate_multi<16>(fields, &arena));
+								  arena.release();
+							  }),
+		   items);
+}
+
+int main()
+{
+	bench_batch("fully valid batch", 0);
+	bench_batch("1% invalid batch", 100);
+	bench_batch("100% invalid batch", 1);
+	return 0;
+}
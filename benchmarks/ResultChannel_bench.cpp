@@ -0,0 +1,203 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: ResultChannel_bench.cpp
+//    Description: Throughput and round trip latency of the lock-free result channels against a
+//                 mutex and condition variable protected std::deque
+//    =================================
+
+#include "ResultChannel.hpp"
+#include "bench.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Message = OwningResult<std::uint64_t, int>;
+
+/// The baseline: what pipeline stages used before the lock-free channels
+class MutexResultChannel
+{
+	public:
+
+	explicit MutexResultChannel(std::size_t capacity) : m_capacity{ capacity } {}
+
+	bool push(Message&& message)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_not_full.wait(lock, [this]() { return m_closed || m_queue.size() < m_capacity; });
+		if (m_closed) return false;
+		m_queue.push_back(std::move(message));
+		m_not_empty.notify_one();
+		return true;
+	}
+
+	std::optional<Message> pop()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_not_empty.wait(lock, [this]() { return m_closed || !m_queue.empty(); });
+		if (m_queue.empty()) return std::nullopt;
+		Message message(std::move(m_queue.front()));
+		m_queue.pop_front();
+		m_not_full.notify_one();
+		return message;
+	}
+
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closed = true;
+		m_not_empty.notify_all();
+		m_not_full.notify_all();
+	}
+
+	private:
+
+	std::size_t				m_capacity;
+	std::deque<Message>		m_queue;
+	std::mutex				m_mutex;
+	std::condition_variable m_not_empty;
+	std::condition_variable m_not_full;
+	bool					m_closed{ false };
+};
+
+// Messages are built up front so that only the channel is measured
+std::vector<Message> make_messages(std::size_t count)
+{
+	std::vector<Message> messages;
+	messages.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+		messages.push_back(OwningOk<std::uint64_t>(std::uint64_t{ i }));
+	return messages;
+}
+
+template<typename Channel>
+double throughput(std::size_t producers, std::size_t consumers, std::size_t per_producer)
+{
+	std::vector<std::vector<Message>> inputs;
+	for (std::size_t p = 0; p < producers; ++p)
+		inputs.push_back(make_messages(per_producer));
+
+	Channel channel(1024);
+	return time_per_iteration(1, [&](std::size_t) {
+		std::vector<std::thread> threads;
+		for (std::size_t c = 0; c < consumers; ++c)
+			threads.emplace_back([&channel]() {
+				std::uint64_t sum = 0;
+				while (auto message = channel.pop())
+					sum += *message->peek_ok();
+				do_not_optimize(sum);
+			});
+		std::vector<std::thread> writers;
+		for (std::size_t p = 0; p < producers; ++p)
+			writers.emplace_back([&channel, &input = inputs[p]]() {
+				for (Message& message : input)
+					channel.push(std::move(message));
+			});
+		for (auto& thread : writers)
+			thread.join();
+		channel.close();
+		for (auto& thread : threads)
+			thread.join();
+	});
+}
+
+double spsc_batch_throughput(std::size_t count, std::size_t batch_size)
+{
+	std::vector<Message>				  input = make_messages(count);
+	SpscResultChannel<std::uint64_t, int> channel(1024);
+	return time_per_iteration(1, [&](std::size_t) {
+		std::thread consumer([&channel, batch_size]() {
+			std::vector<Message> out;
+			out.reserve(batch_size);
+			std::uint64_t sum = 0;
+			while (true)
+			{
+				out.clear();
+				if (channel.pop_n(out, batch_size) == 0)
+				{
+					if (channel.is_closed() && channel.pop_n(out, batch_size) == 0) break;
+					std::this_thread::yield();
+				}
+				for (Message& message : out)
+					sum += *message.peek_ok();
+			}
+			do_not_optimize(sum);
+		});
+		std::span<Message> remaining(input);
+		while (!remaining.empty())
+		{
+			std::size_t chunk  = std::min(batch_size, remaining.size());
+			std::size_t pushed = channel.push_n(remaining.first(chunk));
+			remaining		   = remaining.subspan(pushed);
+			if (pushed == 0) std::this_thread::yield();
+		}
+		channel.close();
+		consumer.join();
+	});
+}
+
+// Round trip of one message through a pair of channels, the reply is the request sent back
+template<typename Channel>
+double round_trip_latency(std::size_t round_trips)
+{
+	Channel requests(64);
+	Channel replies(64);
+
+	std::thread echo([&]() {
+		while (auto message = requests.pop())
+			replies.push(std::move(*message));
+	});
+
+	double time = time_per_iteration(round_trips, [&](std::size_t i) {
+		requests.push(OwningOk<std::uint64_t>(std::uint64_t{ i }));
+		do_not_optimize(replies.pop());
+	});
+	requests.close();
+	echo.join();
+	return time;
+}
+
+int main()
+{
+	constexpr std::size_t count = 1 << 20;
+	constexpr double	  items = static_cast<double>(count);
+	using Spsc					= SpscResultChannel<std::uint64_t, int>;
+	using Mpmc					= MpmcResultChannel<std::uint64_t, int>;
+
+	report("throughput 1p/1c mutex+condvar", throughput<MutexResultChannel>(1, 1, count), items);
+	report("throughput 1p/1c SpscResultChannel", throughput<Spsc>(1, 1, count), items);
+	report("throughput 1p/1c MpmcResultChannel", throughput<Mpmc>(1, 1, count), items);
+	report("throughput 2p/2c mutex+condvar",
+		   throughput<MutexResultChannel>(2, 2, count / 2),
+		   items);
+	report("throughput 2p/2c MpmcResultChannel", throughput<Mpmc>(2, 2, count / 2), items);
+	for (std::size_t batch : { 16, 256 })
+		report("throughput 1p/1c SpscResultChannel push_n/pop_n batch=" + std::to_string(batch),
+			   spsc_batch_throughput(count, batch),
+			   items);
+
+	constexpr std::size_t round_trips = 1 << 14;
+	report("round trip latency mutex+condvar", round_trip_latency<MutexResultChannel>(round_trips));
+	report("round trip latency SpscResultChannel", round_trip_latency<Spsc>(round_trips));
+	report("round trip latency MpmcResultChannel", round_trip_latency<Mpmc>(round_trips));
+	return 0;
+}
@@ -0,0 +1,170 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: ResultStream_bench.cpp
+//    Description: Throughput of parsing a large generated file record by record through a
+//                 ResultStream, against a hand written loop and materializing every result first
+//    =================================
+//
+//    Usage: ResultStream_bench.x [file size in MiB, default 2048]
+
+#include "ResultStream.hpp"
+#include "bench.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Record {
+	std::uint64_t id;
+	double		  value;
+};
+
+struct ParseError {
+	std::uint64_t line;
+};
+
+// One in `bad_every` lines has an unparsable id
+constexpr std::uint64_t bad_every = 1000;
+
+// Lines look like "<id>,<value>,<padding>" and are about 100 bytes long
+std::uint64_t write_input(const std::filesystem::path& path, std::uint64_t bytes)
+{
+	std::ofstream	  out(path, std::ios::binary);
+	const std::string padding(72, 'p');
+	std::string		  line;
+	std::uint64_t	  written = 0;
+	std::uint64_t	  lines	  = 0;
+	for (; written < bytes; ++lines)
+	{
+		line.clear();
+		if (lines % bad_every == bad_every - 1) line += "bad";
+		else line += std::to_string(lines);
+		line += ',';
+		line += std::to_string(static_cast<double>(lines) * 0.25);
+		line += ',';
+		line += padding;
+		line += '\n';
+		out.write(line.data(), static_cast<std::streamsize>(line.size()));
+		written += line.size();
+	}
+	return lines;
+}
+
+bool parse_line(std::string_view line, Record& record)
+{
+	const char* end		  = line.data() + line.size();
+	auto [after_id, error] = std::from_chars(line.data(), end, record.id);
+	if (error != std::errc() || after_id == end || *after_id != ',') return false;
+	auto [after_value, value_error] = std::from_chars(after_id + 1, end, record.value);
+	return value_error == std::errc() && after_value != end && *after_value == ',';
+}
+
+// The line and the record are reused for every line, errors are yielded as borrowed values too
+template<typename Policy>
+ResultStream<Record, ParseError, Policy> parse_file(std::filesystem::path path)
+{
+	std::ifstream in(path, std::ios::binary);
+	std::string	  line;
+	Record		  record{};
+	ParseError	  error{};
+	for (std::uint64_t number = 0; std::getline(in, line); ++number)
+	{
+		if (parse_line(line, record)) [[likely]]
+			co_yield record;
+		else
+		{
+			error.line = number;
+			co_yield BorrowedResult<Record, ParseError>::borrow_err(error);
+		}
+	}
+}
+
+// Baseline: the same work with no results at all
+double checksum_loop(const std::filesystem::path& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	std::string	  line;
+	Record		  record{};
+	double		  sum = 0.0;
+	while (std::getline(in, line))
+		if (parse_line(line, record)) sum += record.value;
+	return sum;
+}
+
+// What ingestion did before: every line becomes an OwningResult, then the batch is processed
+double checksum_materialized(const std::filesystem::path& path)
+{
+	std::ifstream								  in(path, std::ios::binary);
+	std::string									  line;
+	Record										  record{};
+	std::vector<OwningResult<Record, ParseError>> results;
+	for (std::uint64_t number = 0; std::getline(in, line); ++number)
+	{
+		if (parse_line(line, record)) results.emplace_back(OwningOk<Record>(std::move(record)));
+		else results.emplace_back(OwningErr<ParseError>(ParseError{ number }));
+	}
+	double sum = 0.0;
+	for (auto& result : results)
+		if (const Record* ok = result.peek_ok()) sum += ok->value;
+	return sum;
+}
+
+template<typename Policy>
+double checksum_stream(const std::filesystem::path& path)
+{
+	auto   stream = parse_file<Policy>(path);
+	double sum	  = 0.0;
+	for (auto record : stream)
+		if (record.is_ok()) sum += record.unwrap().value;
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	std::uint64_t mib	= argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+	TempFile	  input{ "ResultStream_bench" };
+	const auto&	  path	= input.path();
+	double		  lines = static_cast<double>(write_input(path, mib << 20));
+	std::cout << "input: " << mib << " MiB, " << static_cast<std::uint64_t>(lines) << " lines\n";
+
+	// One untimed pass so every variant reads from the page cache
+	do_not_optimize(checksum_loop(path));
+
+	report("getline loop, no results",
+		   time_per_iteration(1, [&](std::size_t) { do_not_optimize(checksum_loop(path)); }),
+		   lines);
+	report("ResultStream, SkipErrors",
+		   time_per_iteration(
+			   1, [&](std::size_t) { do_not_optimize(checksum_stream<SkipErrors>(path)); }),
+		   lines);
+	report("ResultStream, CollectErrors<64>",
+		   time_per_iteration(
+			   1, [&](std::size_t) { do_not_optimize(checksum_stream<CollectErrors<64>>(path)); }),
+		   lines);
+	report("materialize vector<OwningResult>, then iterate",
+		   time_per_iteration(1,
+							  [&](std::size_t) { do_not_optimize(checksum_materialized(path)); }),
+		   lines);
+	return 0;
+}
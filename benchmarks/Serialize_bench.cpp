@@ -0,0 +1,130 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Serialize_bench.cpp
+//    Description: Throughput of encoding results into, and reading them back from, an mmap'd
+//                 temporary file
+//    =================================
+
+#include "Serialize.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+struct Sample {
+	std::uint64_t timestamp;
+	double		  value;
+	std::uint32_t sensor;
+	std::uint32_t flags;
+};
+
+enum class SampleError : std::uint32_t {
+	OutOfRange,
+	Checksum
+};
+
+using SampleResult = OwningResult<Sample, SampleError>;
+
+// Maps `size` bytes of the file open as `fd`, terminating on failure
+std::byte* map_file(int fd, std::size_t size, int protection)
+{
+	void* address = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+	ASSERT(address != MAP_FAILED, "mmap of benchmark file failed");
+	return static_cast<std::byte*>(address);
+}
+
+int main()
+{
+	constexpr std::size_t count = 1 << 20;
+
+	std::vector<SampleResult> results;
+	results.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (i % 100 == 0) results.push_back(OwningErr<SampleError>(SampleError::Checksum));
+		else
+			results.push_back(OwningOk<Sample>(
+				Sample{ i, static_cast<double>(i) * 0.5, static_cast<std::uint32_t>(i % 64), 0 }));
+	}
+
+	char path[] = "/tmp/result_serialize_bench_XXXXXX";
+	int	 fd		= mkstemp(path);
+	ASSERT(fd >= 0, "could not create temporary file");
+	std::size_t size = encoded_size_of_results<Sample, SampleError>(results);
+	ASSERT(ftruncate(fd, static_cast<off_t>(size)) == 0, "could not size temporary file");
+
+	// Writer process side: encode straight into the shared mapping
+	std::byte* out	= map_file(fd, size, PROT_READ | PROT_WRITE);
+	double	   time = time_per_iteration(5, [&](std::size_t) {
+		  do_not_optimize(encode_results<Sample, SampleError>(results, std::span<std::byte>(out, size)));
+	  });
+	report("encode_results into mmap", time, static_cast<double>(count));
+	msync(out, size, MS_SYNC);
+	munmap(out, size);
+
+	// Reader process side: a fresh read only mapping of the same file
+	const std::byte* in = map_file(fd, size, PROT_READ);
+	auto			 bytes = std::span<const std::byte>(in, size);
+
+	time = time_per_iteration(5, [&](std::size_t) {
+		do_not_optimize(ResultBatchView<Sample, SampleError>::from_bytes(bytes).is_ok());
+	});
+	report("ResultBatchView::from_bytes (validation)", time, static_cast<double>(count));
+
+	auto batch = ResultBatchView<Sample, SampleError>::from_bytes(bytes).unwrap();
+	time	   = time_per_iteration(5, [&](std::size_t) {
+		  double sum = 0.0;
+		  for (std::size_t i = 0; i < batch.size(); ++i)
+		  {
+			  auto record = batch[i];
+			  if (record.is_ok()) sum += record.ok_ref().value;
+		  }
+		  do_not_optimize(sum);
+	  });
+	report("read in place (ok_ref)", time, static_cast<double>(count));
+
+	time = time_per_iteration(5, [&](std::size_t) {
+		double sum = 0.0;
+		for (std::size_t i = 0; i < batch.size(); ++i)
+		{
+			auto record = batch[i];
+			if (record.is_ok()) sum += record.decode_ok().value;
+		}
+		do_not_optimize(sum);
+	});
+	report("decode copy (decode_ok)", time, static_cast<double>(count));
+
+	time = time_per_iteration(1, [&](std::size_t) {
+		std::vector<SampleResult> owned;
+		owned.reserve(batch.size());
+		for (std::size_t i = 0; i < batch.size(); ++i)
+			owned.push_back(batch[i].to_owned());
+		do_not_optimize(owned.size());
+	});
+	report("full deserialization (to_owned)", time, static_cast<double>(count));
+
+	munmap(const_cast<std::byte*>(in), size);
+	close(fd);
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,147 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: ThunkGraph_bench.cpp
+//    Description: Compares ThunkGraph evaluation of wide and deep synthetic graphs against
+//                 evaluating the same thunks serially
+//    =================================
+
+#include "ThunkGraph.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Graph = ThunkGraph<std::uint64_t, std::string>;
+
+// Synthetic unit of work, roughly a microsecond per 1000 rounds
+std::uint64_t spin(std::uint64_t seed, std::size_t rounds)
+{
+	for (std::size_t i = 0; i < rounds; ++i)
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed;
+}
+
+Graph::ThunkFunction make_thunk(std::size_t rounds)
+{
+	return [rounds](Graph::ThunkInputs inputs) -> OwningResult<std::uint64_t, std::string> {
+		std::uint64_t seed = 1;
+		for (const std::uint64_t* input : inputs)
+			seed ^= *input;
+		return OwningOk<std::uint64_t>(spin(seed, rounds));
+	};
+}
+
+// The graph, and with it the worker pool, is built once outside the timed loop. Evaluated nodes
+// are never run again, so every iteration appends and evaluates a fresh copy of the nodes.
+
+// `width` independent leaves all feeding a single sink
+double bench_wide(std::size_t width, std::size_t rounds, std::size_t num_threads)
+{
+	Graph graph(num_threads);
+	return time_per_iteration(10, [&](std::size_t) {
+		std::vector<Graph::NodeId> leaves;
+		for (std::size_t i = 0; i < width; ++i)
+			leaves.push_back(graph.add(make_thunk(rounds)));
+		Graph::NodeId sink = graph.add(make_thunk(rounds), leaves);
+		graph.evaluate(sink);
+		do_not_optimize(graph.get(sink));
+	});
+}
+
+// `width` independent chains of length `depth`, joined by a single sink
+double bench_deep(std::size_t depth,
+				  std::size_t width,
+				  std::size_t rounds,
+				  std::size_t num_threads)
+{
+	Graph graph(num_threads);
+	return time_per_iteration(10, [&](std::size_t) {
+		std::vector<Graph::NodeId> tails;
+		for (std::size_t w = 0; w < width; ++w)
+		{
+			Graph::NodeId previous = graph.add(make_thunk(rounds));
+			for (std::size_t d = 1; d < depth; ++d)
+				previous = graph.add(make_thunk(rounds), { previous });
+			tails.push_back(previous);
+		}
+		Graph::NodeId sink = graph.add(make_thunk(rounds), tails);
+		graph.evaluate(sink);
+		do_not_optimize(graph.get(sink));
+	});
+}
+
+// Starting and joining the worker pool, which the other benchmarks leave out
+double bench_startup(std::size_t num_threads)
+{
+	return time_per_iteration(10, [&](std::size_t) {
+		Graph graph(num_threads);
+		do_not_optimize(graph);
+	});
+}
+
+// Baseline: the same amount of work done in a plain loop on the calling thread
+double bench_serial(std::size_t num_nodes, std::size_t rounds)
+{
+	return time_per_iteration(10, [&](std::size_t) {
+		std::uint64_t seed = 1;
+		for (std::size_t i = 0; i < num_nodes; ++i)
+			seed ^= spin(1, rounds);
+		do_not_optimize(seed);
+	});
+}
+
+int main()
+{
+	std::size_t hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	std::size_t rounds	 = 20000;
+
+	report("ThunkGraph startup, 1 thread", bench_startup(1));
+	report("ThunkGraph startup, " + std::to_string(hardware) + " threads",
+		   bench_startup(hardware));
+
+	for (std::size_t width : { 64, 1024 })
+	{
+		std::string suffix = " width=" + std::to_string(width);
+		double		items  = static_cast<double>(width + 1);
+		report("serial loop" + suffix, bench_serial(width + 1, rounds), items);
+		report("ThunkGraph wide, 1 thread" + suffix, bench_wide(width, rounds, 1), items);
+		report("ThunkGraph wide, " + std::to_string(hardware) + " threads" + suffix,
+			   bench_wide(width, rounds, hardware),
+			   items);
+	}
+
+	for (std::size_t depth : { 64, 512 })
+	{
+		std::size_t width  = 8;
+		std::string suffix = " depth=" + std::to_string(depth) + " chains=8";
+		double		items  = static_cast<double>(depth * width + 1);
+		report("serial loop" + suffix, bench_serial(depth * width + 1, rounds), items);
+		report("ThunkGraph deep, 1 thread" + suffix, bench_deep(depth, width, rounds, 1), items);
+		report("ThunkGraph deep, " + std::to_string(hardware) + " threads" + suffix,
+			   bench_deep(depth, width, rounds, hardware),
+			   items);
+	}
+
+	// Node overhead: no work per node
+	report("ThunkGraph wide, empty thunks width=4096",
+		   bench_wide(4096, 0, hardware),
+		   static_cast<double>(4097));
+	return 0;
+}
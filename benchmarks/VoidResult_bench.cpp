@@ -0,0 +1,76 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: VoidResult_bench.cpp
+//    Description: Cost of returning success or an error code from a function that has no value to
+//                 return, with and without the OwningResult<void, E> specialization
+//    =================================
+
+#include "Result.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+
+constexpr std::size_t iterations = 1 << 22;
+
+enum class ErrCode : std::uint32_t
+{
+	ok = 0,
+	timeout,
+};
+
+// Fails one call in 128
+[[gnu::noinline]] ErrCode check_code(std::size_t i)
+{
+	return (i & 127) == 127 ? ErrCode::timeout : ErrCode::ok;
+}
+
+[[gnu::noinline]] OwningResult<void, ErrCode> check_void(std::size_t i)
+{
+	if ((i & 127) == 127) return ErrCode::timeout;
+	return OwningOk<void>();
+}
+
+// What status-only functions had to do before: return a dummy value in a boxed Ok
+[[gnu::noinline]] OwningResult<bool, ErrCode> check_boxed(std::size_t i)
+{
+	if ((i & 127) == 127) return OwningErr<ErrCode>(ErrCode::timeout);
+	return OwningOk<bool>(true);
+}
+
+int main()
+{
+	std::cout << "sizeof(ErrCode)                     = " << sizeof(ErrCode) << "\n"
+			  << "sizeof(OwningResult<void, ErrCode>) = " << sizeof(OwningResult<void, ErrCode>)
+			  << "\n"
+			  << "sizeof(OwningResult<bool, ErrCode>) = " << sizeof(OwningResult<bool, ErrCode>)
+			  << " + one heap allocation\n";
+
+	report("plain error code",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   do_not_optimize(check_code(i) == ErrCode::ok);
+		   }));
+	report("OwningResult<void, ErrCode>",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   do_not_optimize(check_void(i).is_ok());
+		   }));
+	report("OwningResult<bool, ErrCode> (boxed dummy value)",
+		   time_per_iteration(iterations, [](std::size_t i) {
+			   do_not_optimize(check_boxed(i).is_ok());
+		   }));
+	return 0;
+}
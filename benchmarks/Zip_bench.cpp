@@ -0,0 +1,178 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Zip_bench.cpp
+//    Description: Compares combining five parsed fields with zip against nested ifs, with a
+//                 varying fraction of records holding a bad field
+//    =================================
+
+#include "Zip.hpp"
+#include "bench.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr std::size_t num_records = 1 << 14;
+constexpr std::size_t num_fields  = 5;
+constexpr std::size_t passes	  = 50;
+
+struct ParseError {
+	std::uint32_t field;
+	std::uint32_t code;
+};
+
+using Field	 = OwningResult<int, ParseError>;
+using Record = std::array<std::string, num_fields>;
+
+[[gnu::noinline]] Field parse_field(std::string_view text, std::uint32_t field)
+{
+	int value = 0;
+	auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (error != std::errc() || end != text.data() + text.size()) [[unlikely]]
+		return OwningErr<ParseError>(ParseError{ field, 1 });
+	return OwningOk<int>(std::move(value));
+}
+
+// A fraction `bad_rate` of the records has one unparsable field, at a random position
+std::vector<Record> make_records(double bad_rate)
+{
+	std::vector<Record> records(num_records);
+	std::uint64_t		state	  = 0x9E3779B97F4A7C15ULL;
+	auto				threshold = static_cast<std::uint64_t>(bad_rate * 18446744073709551615.0);
+	for (std::size_t i = 0; i < num_records; ++i)
+	{
+		for (std::size_t f = 0; f < num_fields; ++f)
+			records[i][f] = std::to_string(i * num_fields + f);
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		if (state < threshold) records[i][(state >> 33) % num_fields].front() = 'x';
+	}
+	return records;
+}
+
+std::array<Field, num_fields> parse_record(const Record& record)
+{
+	return { parse_field(record[0], 0), parse_field(record[1], 1), parse_field(record[2], 2),
+			 parse_field(record[3], 3), parse_field(record[4], 4) };
+}
+
+// The hand written version: one branch per field, first error wins
+std::int64_t combine_nested(std::array<Field, num_fields>& f)
+{
+	if (f[0].is_ok())
+		if (f[1].is_ok())
+			if (f[2].is_ok())
+				if (f[3].is_ok())
+					if (f[4].is_ok())
+						return f[0].unwrap() + f[1].unwrap() + f[2].unwrap() + f[3].unwrap()
+							 + f[4].unwrap();
+					else return -static_cast<std::int64_t>(f[4].err()->field);
+				else return -static_cast<std::int64_t>(f[3].err()->field);
+			else return -static_cast<std::int64_t>(f[2].err()->field);
+		else return -static_cast<std::int64_t>(f[1].err()->field);
+	else return -static_cast<std::int64_t>(f[0].err()->field);
+}
+
+std::int64_t combine_zip(std::array<Field, num_fields>& f)
+{
+	return match(
+		zip(f[0], f[1], f[2], f[3], f[4]),
+		[](int a, int b, int c, int d, int e) -> std::int64_t { return a + b + c + d + e; },
+		[](ParseError&& error) { return -static_cast<std::int64_t>(error.field); });
+}
+
+// Only the check, results reused: && short circuits field by field, all_ok is one branch
+std::int64_t check_and_chain(const std::array<Field, num_fields>& f)
+{
+	if (f[0].is_ok() && f[1].is_ok() && f[2].is_ok() && f[3].is_ok() && f[4].is_ok())
+		return *f[0].peek_ok() + *f[4].peek_ok();
+	return -1;
+}
+
+std::int64_t check_all_ok(const std::array<Field, num_fields>& f)
+{
+	if (all_ok(f[0], f[1], f[2], f[3], f[4])) return *f[0].peek_ok() + *f[4].peek_ok();
+	return -1;
+}
+
+void bench_bad_rate(double bad_rate)
+{
+	std::vector<Record> records = make_records(bad_rate);
+	double				items	= static_cast<double>(num_records);
+
+	report("  parse + nested ifs",
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  std::int64_t sum = 0;
+								  for (const Record& record : records)
+								  {
+									  auto fields = parse_record(record);
+									  sum += combine_nested(fields);
+								  }
+								  do_not_optimize(sum);
+							  }),
+		   items);
+	report("  parse + zip + match",
+		   time_per_iteration(passes,
+							  [&](std::size_t) {
+								  std::int64_t sum = 0;
+								  for (const Record& record : records)
+								  {
+									  auto fields = parse_record(record);
+									  sum += combine_zip(fields);
+								  }
+								  do_not_optimize(sum);
+							  }),
+		   items);
+
+	std::vector<std::array<Field, num_fields>> parsed;
+	parsed.reserve(num_records);
+	for (const Record& record : records)
+		parsed.push_back(parse_record(record));
+	report("  check only, && chain",
+		   time_per_iteration(passes * 10,
+							  [&](std::size_t) {
+								  std::int64_t sum = 0;
+								  for (const auto& fields : parsed)
+									  sum += check_and_chain(fields);
+								  do_not_optimize(sum);
+							  }),
+		   items);
+	report("  check only, all_ok",
+		   time_per_iteration(passes * 10,
+							  [&](std::size_t) {
+								  std::int64_t sum = 0;
+								  for (const auto& fields : parsed)
+									  sum += check_all_ok(fields);
+								  do_not_optimize(sum);
+							  }),
+		   items);
+}
+
+int main()
+{
+	for (double bad_rate : { 0.0, 0.01, 0.1, 0.5 })
+	{
+		std::cout << "records with a bad field " << bad_rate * 100.0 << "%\n";
+		bench_bad_rate(bad_rate);
+	}
+	return 0;
+}
@@ -0,0 +1,228 @@
+//  Copyright 2021-2022 Liam Clink and Kevin Ingles
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the right to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Sofware is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial poritions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//  SOFTWARE OR THE USE OF OTHER DEALINGS IN THE SOFTWARE
+//
+//  ==================================
+//  Author: Kevin Ingles
+//  File: bench.hpp
+//  Description: Contains the main preamble to run benchmarks
+//  ==================================
+
+#ifndef OL_BENCH_HPP
+#define OL_BENCH_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+
+/// Keeps the compiler from optimizing away a value that is computed only to be measured
+template<typename T>
+inline void do_not_optimize(T const& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Runs `func` `iterations` times and returns the average wall clock time per call in
+/// nanoseconds
+template<typename Func>
+double time_per_iteration(std::size_t iterations, Func&& func)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+		func(i);
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(stop - start).count()
+		 / static_cast<double>(iterations);
+}
+
+/// Prints one line of benchmark output: name, time per operation and an optional throughput
+inline void report(std::string_view name, double ns_per_op, double items_per_op = 0.0)
+{
+	std::cout << std::left << std::setw(56) << name << std::right << std::setw(14) << std::fixed
+			  << std::setprecision(2) << ns_per_op << " ns/op";
+	if (items_per_op > 0.0)
+		std::cout << std::setw(14) << std::setprecision(2) << items_per_op * 1e3 / ns_per_op
+				  << " M items/s";
+	std::cout << "\n";
+}
+
+/// Counts the branch mispredictions of the calling thread with perf_event_open.
+/// Unavailable off Linux, in most containers, and when kernel.perf_event_paranoid forbids it.
+class BranchMissCounter
+{
+	public:
+
+	BranchMissCounter(void)
+	{
+#ifdef __linux__
+		perf_event_attr attr{};
+		attr.type			= PERF_TYPE_HARDWARE;
+		attr.size			= sizeof(attr);
+		attr.config			= PERF_COUNT_HW_BRANCH_MISSES;
+		attr.disabled		= 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv		= 1;
+		m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+	}
+
+	~BranchMissCounter(void)
+	{
+#ifdef __linux__
+		if (m_fd >= 0) close(m_fd);
+#endif
+	}
+
+	BranchMissCounter(const BranchMissCounter&)			   = delete;
+	BranchMissCounter& operator=(const BranchMissCounter&) = delete;
+
+	[[nodiscard]] bool available(void) const noexcept { return m_fd >= 0; }
+
+	/// Runs `func` once and returns the branch misses it caused, nullopt if unavailable
+	template<typename Func>
+	std::optional<std::uint64_t> measure(Func&& func)
+	{
+#ifdef __linux__
+		if (m_fd >= 0)
+		{
+			ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+			func();
+			ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+			std::uint64_t count = 0;
+			if (read(m_fd, &count, sizeof(count)) == sizeof(count)) return count;
+			return std::nullopt;
+		}
+#endif
+		func();
+		return std::nullopt;
+	}
+
+	private:
+
+	int m_fd{ -1 };
+};
+
+/// Input file for benchmarks that read from disk.
+/// The name is unique, so concurrent runs do not clobber each other's input, and the file is
+/// removed again however the benchmark ends: on return, on an exception, on std::terminate
+/// (e.g. a failed ASSERT) and on SIGINT or SIGTERM. Only one may exist at a time.
+class TempFile
+{
+	public:
+
+	explicit TempFile(std::string_view stem)
+	{
+		std::string name = (std::filesystem::temp_directory_path() / stem).string();
+#if defined(__unix__) || defined(__APPLE__)
+		name += "-XXXXXX";
+#else
+		name += "-" + std::to_string(std::random_device{}());
+#endif
+		if (name.size() >= sizeof(s_live_path))
+		{
+			auto error = std::make_error_code(std::errc::filename_too_long);
+			throw std::filesystem::filesystem_error("temporary file path too long", name, error);
+		}
+#if defined(__unix__) || defined(__APPLE__)
+		int fd = mkstemp(name.data());
+		if (fd < 0)
+		{
+			std::error_code error(errno, std::generic_category());
+			throw std::filesystem::filesystem_error("cannot create a temporary file", name, error);
+		}
+		close(fd);
+#endif
+		m_path = name;
+		std::memcpy(s_live_path, name.c_str(), name.size() + 1);
+		s_previous_terminate = std::set_terminate(on_terminate);
+		std::signal(SIGINT, on_signal);
+		std::signal(SIGTERM, on_signal);
+	}
+
+	~TempFile(void)
+	{
+		std::signal(SIGINT, SIG_DFL);
+		std::signal(SIGTERM, SIG_DFL);
+		std::set_terminate(s_previous_terminate);
+		s_live_path[0] = '\0';
+		std::error_code ignored;
+		std::filesystem::remove(m_path, ignored);
+	}
+
+	TempFile(const TempFile&)			 = delete;
+	TempFile& operator=(const TempFile&) = delete;
+
+	[[nodiscard]] const std::filesystem::path& path(void) const noexcept { return m_path; }
+
+	private:
+
+	// Only async-signal-safe calls from here on
+	static void remove_live_path(void) noexcept
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		if (s_live_path[0] != '\0') unlink(s_live_path);
+#else
+		if (s_live_path[0] != '\0') std::remove(s_live_path);
+#endif
+	}
+
+	static void on_signal(int signal) noexcept
+	{
+		remove_live_path();
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+
+	[[noreturn]] static void on_terminate(void) noexcept
+	{
+		remove_live_path();
+		if (s_previous_terminate != nullptr) s_previous_terminate();
+		std::abort();
+	}
+
+	std::filesystem::path				  m_path;
+	inline static char					  s_live_path[4096]{};
+	inline static std::terminate_handler s_previous_terminate{ nullptr };
+};
+
+#endif
@@ -23,15 +23,46 @@
 #ifndef OL_ASSERTION_HPP
 #define OL_ASSERTION_HPP
 
+#include <exception>
 #include <iostream>
 
+namespace detail
+{
+	[[gnu::cold, gnu::noinline]] inline std::ostream&
+	begin_assertion_report(const char* condition, const char* file, int line)
+	{
+		return std::cerr << "Assertion " << condition << "failed in " << file << " line " << line
+						 << ": ";
+	}
+
+	[[noreturn, gnu::cold, gnu::noinline]] inline void end_assertion_report(std::ostream& out)
+	{
+		out << "\n";
+		std::terminate();
+	}
+
+	/// Reports a failed `ASSERT` and terminates.
+	/// Kept out of line and cold, so that inlined checks only cost a compare and a call, and the
+	/// stream formatting is laid out away from the code that passes its checks. Only writing the
+	/// message is instantiated per call site.
+	template<typename WriteMessage>
+	[[noreturn, gnu::cold, gnu::noinline]] void
+	assertion_failed(const char* condition, const char* file, int line, WriteMessage& message)
+	{
+		std::ostream& out = begin_assertion_report(condition, file, line);
+		message(out);
+		end_assertion_report(out);
+	}
+} // namespace detail
+
 #define ASSERT(condition, message)                                                                \
   {                                                                                               \
-	if (!(condition))                                                                             \
+	if (!(condition)) [[unlikely]]                                                                \
 	{                                                                                             \
-	  std::cerr << "Assertion " << #condition << "failed in " << __FILE__ << " line " << __LINE__ \
-				<< ": " << message << "\n";                                                       \
-	  std::terminate();                                                                           \
+	  auto write_assert_message = [&](std::ostream& assert_stream_) {                             \
+		  assert_stream_ << message;                                                              \
+	  };                                                                                          \
+	  ::detail::assertion_failed(#condition, __FILE__, __LINE__, write_assert_message);           \
 	}                                                                                             \
   }
 
@@ -0,0 +1,150 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: Bridge.hpp
+// Description: Conversions between `OwningResult<T, E>`, `std::expected<T, E>` and code that
+//              reports errors with exceptions
+// =================================
+//
+
+#ifndef OL_BRIDGE_HPP
+#define OL_BRIDGE_HPP
+
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#  include <expected>
+#  define OL_HAS_EXPECTED 1
+#endif
+
+#include "Result.hpp"
+
+// None of the conversions below allocate on their own or copy the payload: values are moved out
+// of, or into, the single heap allocation an `OwningOk<T>` or `OwningErr<E>` owns.
+// Converting to another type frees that allocation, converting from another type makes it.
+
+#ifdef OL_HAS_EXPECTED
+/// Converts `OwningResult<T, E>` to `std::expected<T, E>`, moving the contained value
+template<typename T, typename E, LikelihoodPolicy Likelihood, CheckingPolicy Checking>
+[[nodiscard]] std::expected<T, E> to_expected(OwningResult<T, E, Likelihood, Checking>&& result)
+{
+	if (result.is_ok()) return std::expected<T, E>(std::in_place, result.unwrap());
+	return std::expected<T, E>(std::unexpect, *std::move(result.err()));
+}
+
+/// Converts `std::expected<T, E>` to `OwningResult<T, E>`, moving the contained value
+template<typename T, typename E>
+[[nodiscard]] OwningResult<T, E> from_expected(std::expected<T, E>&& expected)
+{
+	if (expected.has_value()) return OwningOk<T>(std::move(*expected));
+	return OwningErr<E>(std::move(expected.error()));
+}
+#endif
+
+/// Thrown by `or_throw` when the error type is not itself an exception
+template<typename E>
+class BadResultAccess : public std::exception
+{
+	public:
+
+	explicit BadResultAccess(E&& error) : m_error{ std::move(error) } {}
+
+	const char* what() const noexcept override { return "or_throw called on an Err result"; }
+
+	E&		 error() & noexcept { return m_error; }
+	const E& error() const& noexcept { return m_error; }
+	E&&		 error() && noexcept { return std::move(m_error); }
+
+	private:
+
+	E m_error;
+};
+
+/// Calls `func` and captures whatever it throws in an `OwningErr<std::exception_ptr>`
+template<typename Func>
+[[nodiscard]] auto try_invoke(Func&& func)
+	-> OwningResult<std::invoke_result_t<Func>, std::exception_ptr>
+{
+	using T = std::invoke_result_t<Func>;
+	static_assert(!std::is_void_v<T> && !std::is_reference_v<T>,
+				  "try_invoke needs a callable returning a value");
+	try
+	{
+		return OwningOk<T>(std::invoke(std::forward<Func>(func)));
+	}
+	catch (...)
+	{
+		return OwningErr<std::exception_ptr>(std::current_exception());
+	}
+}
+
+/// Calls `func` and maps what it throws to an error with `mapper`.
+/// If `mapper` takes `const std::exception&`, only exceptions deriving from `std::exception` are
+/// caught and anything else propagates. If it takes `std::exception_ptr`, everything is caught.
+template<typename Func, typename Mapper>
+[[nodiscard]] auto try_invoke(Func&& func, Mapper&& mapper)
+{
+	using T = std::invoke_result_t<Func>;
+	static_assert(!std::is_void_v<T> && !std::is_reference_v<T>,
+				  "try_invoke needs a callable returning a value");
+	if constexpr (std::is_invocable_v<Mapper, const std::exception&>)
+	{
+		using E = std::decay_t<std::invoke_result_t<Mapper, const std::exception&>>;
+		try
+		{
+			return OwningResult<T, E>(OwningOk<T>(std::invoke(std::forward<Func>(func))));
+		}
+		catch (const std::exception& exception)
+		{
+			return OwningResult<T, E>(OwningErr<E>(std::invoke(mapper, exception)));
+		}
+	}
+	else
+	{
+		static_assert(std::is_invocable_v<Mapper, std::exception_ptr>,
+					  "try_invoke mapper must take const std::exception& or std::exception_ptr");
+		using E = std::decay_t<std::invoke_result_t<Mapper, std::exception_ptr>>;
+		try
+		{
+			return OwningResult<T, E>(OwningOk<T>(std::invoke(std::forward<Func>(func))));
+		}
+		catch (...)
+		{
+			return OwningResult<T, E>(OwningErr<E>(std::invoke(mapper, std::current_exception())));
+		}
+	}
+}
+
+/// Returns the contained `OwningOk<T>` value or throws the error.
+/// Errors deriving from `std::exception` are thrown as they are, `std::exception_ptr` is
+/// rethrown, and any other error is thrown wrapped in a `BadResultAccess<E>`.
+template<typename T, typename E, LikelihoodPolicy Likelihood, CheckingPolicy Checking>
+T or_throw(OwningResult<T, E, Likelihood, Checking>&& result)
+{
+	if (result.is_ok()) return result.unwrap();
+
+	E error = *std::move(result.err());
+	if constexpr (std::is_same_v<E, std::exception_ptr>) std::rethrow_exception(std::move(error));
+	else if constexpr (std::is_base_of_v<std::exception, E>) throw std::move(error);
+	else throw BadResultAccess<E>(std::move(error));
+}
+
+#endif
@@ -0,0 +1,106 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: Checking.hpp
+// Description: Checking policies that decide how much misuse of an `OwningResult` is detected,
+//              and what the detection costs
+// =================================
+//
+
+#ifndef OL_CHECKING_HPP
+#define OL_CHECKING_HPP
+
+#include <concepts>
+#include <type_traits>
+
+/// Tracks consumption: using a consumed or moved-from result, or unwrapping the wrong side,
+/// interrupts execution. The default
+struct FullChecks {
+};
+
+/// Only checks that the side being unwrapped is the one held. Nothing records whether a result
+/// was consumed, using it twice is undefined behaviour
+struct LightChecks {
+};
+
+/// Checks nothing. Unwrapping the wrong side or using a result twice is undefined behaviour
+struct NoChecks {
+};
+
+template<typename Policy>
+concept CheckingPolicy = std::same_as<Policy, FullChecks> || std::same_as<Policy, LightChecks>
+					  || std::same_as<Policy, NoChecks>;
+
+// The level used when `OwningResult` is not given one: 2 for full, 1 for light, 0 for none.
+// Set it for the whole program, e.g. -DOL_RESULT_CHECKING=0 in builds that are known correct;
+// translation units built with different levels must not share results.
+#ifndef OL_RESULT_CHECKING
+#  define OL_RESULT_CHECKING 2
+#endif
+
+#if OL_RESULT_CHECKING == 2
+using DefaultChecking = FullChecks;
+#elif OL_RESULT_CHECKING == 1
+using DefaultChecking = LightChecks;
+#elif OL_RESULT_CHECKING == 0
+using DefaultChecking = NoChecks;
+#else
+#  error "OL_RESULT_CHECKING must be 0 (none), 1 (light) or 2 (full)"
+#endif
+
+namespace detail
+{
+	/// Whether unwrapping checks the result holds the side asked for
+	template<CheckingPolicy Policy>
+	inline constexpr bool checks_side = !std::is_same_v<Policy, NoChecks>;
+
+	/// Whether using a result after it was consumed is detected
+	template<CheckingPolicy Policy>
+	inline constexpr bool checks_consumed = std::is_same_v<Policy, FullChecks>;
+
+	/// The consumed flag of a result. Without `FullChecks` it takes no space and always reads
+	/// false, so every test of it folds away.
+	template<CheckingPolicy Policy>
+	class ConsumedFlag
+	{
+		public:
+
+		constexpr explicit ConsumedFlag(bool) noexcept {}
+
+		[[nodiscard]] constexpr bool is_set(void) const noexcept { return false; }
+
+		constexpr void set(void) noexcept {}
+	};
+
+	template<>
+	class ConsumedFlag<FullChecks>
+	{
+		public:
+
+		constexpr explicit ConsumedFlag(bool consumed) noexcept : m_consumed{ consumed } {}
+
+		[[nodiscard]] constexpr bool is_set(void) const noexcept { return m_consumed; }
+
+		constexpr void set(void) noexcept { m_consumed = true; }
+
+		private:
+
+		bool m_consumed;
+	};
+} // namespace detail
+
+#endif
@@ -33,6 +33,7 @@
 
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 /// Generic empty struct that can be used to zero initialize the Err classes
 template<typename E>
@@ -60,11 +61,10 @@ class OwningErr
 	{
 		if constexpr (std::is_pointer<E>::value)
 		{
-			m_stored_value = std::make_unique<underlying_type>();
 			m_stored_value.reset(value);
 			value = nullptr;
 		}
-		else { m_stored_value = std::make_unique<underlying_type>(value); }
+		else { m_stored_value = std::make_unique<underlying_type>(std::move(value)); }
 	}
 
 	template<typename U>
@@ -74,16 +74,64 @@ class OwningErr
 
 	OwningErr(VoidErr<E>) noexcept : m_stored_value{} {}
 
-	underlying_type& get(void) { return *m_stored_value.release(); }
+	underlying_type& get(void) { return *m_stored_value; }
 
 	[[nodiscard]] underlying_type* release(void) { return m_stored_value.release(); }
 
+	/// Read only access to the stored value without giving up ownership, nullptr if empty
+	[[nodiscard]] const underlying_type* peek(void) const noexcept { return m_stored_value.get(); }
+
 	private:
 
 	// pointer to stored information
 	std::unique_ptr<underlying_type> m_stored_value;
 };
 
+/// OwningErr for types without state, e.g. tag types.
+/// There is nothing worth a heap allocation, so the value is stored inline and takes no space
+/// in an enclosing `[[no_unique_address]]` member.
+/// Only default constructible types qualify, `VoidErr<E>` has to conjure one up; the others are
+/// boxed like any other type.
+template<typename E>
+	requires(std::is_empty_v<E> && std::is_default_constructible_v<E>)
+class OwningErr<E>
+{
+	public:
+
+	using underlying_type = E;
+
+	OwningErr() = default;
+
+	OwningErr(E&& value) noexcept : m_stored_value{ std::move(value) } {}
+
+	OwningErr(VoidErr<E>) noexcept : m_stored_value{} {}
+
+	underlying_type& get(void) { return m_stored_value; }
+
+	/// Nothing was allocated that could be handed over, move the value out of `get()` instead
+	underlying_type* release(void) = delete;
+
+	/// Never nullptr, there is always a value without state to look at
+	[[nodiscard]] const underlying_type* peek(void) const noexcept { return &m_stored_value; }
+
+	private:
+
+	[[no_unique_address]] E m_stored_value;
+};
+
+/// OwningErr<void> only marks failure, there is no value to own
+template<>
+class OwningErr<void>
+{
+	public:
+
+	using underlying_type = void;
+
+	OwningErr() = default;
+
+	OwningErr(VoidErr<void>) noexcept {}
+};
+
 /// NonowningErr only takes by reference and only stores a reference.
 /// The user should ensure that the lifetime of the object does not terminate before the instance
 /// of the NonowningErr has terminated, otherwise you would be accessing a nullptr
@@ -0,0 +1,68 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: Likelihood.hpp
+// Description: Branch likelihood policies that tell the compiler which of Ok or Err to optimize
+//              `OwningResult<T, E, Likelihood>` for
+// =================================
+//
+
+#ifndef OL_LIKELIHOOD_HPP
+#define OL_LIKELIHOOD_HPP
+
+#include <concepts>
+#include <type_traits>
+
+/// Results that almost always succeed, e.g. cache lookups. The default
+struct OkLikely {
+};
+
+/// Results that fail often, e.g. validation of untrusted input
+struct ErrLikely {
+};
+
+/// No hint, leave the layout to the compiler's own heuristics
+struct Neutral {
+};
+
+template<typename Policy>
+concept LikelihoodPolicy = std::same_as<Policy, OkLikely> || std::same_as<Policy, ErrLikely>
+						|| std::same_as<Policy, Neutral>;
+
+namespace detail
+{
+	/// Returns `is_ok` annotated with the probability the policy assigns to it.
+	/// `__builtin_expect` is used where available because, unlike `[[likely]]` on a branch inside
+	/// this function, the hint follows the value through inlining into whichever branch tests it.
+	template<LikelihoodPolicy Policy>
+	[[nodiscard, gnu::always_inline]] constexpr bool predict_ok(bool is_ok) noexcept
+	{
+		if constexpr (std::is_same_v<Policy, Neutral>) return is_ok;
+		else
+		{
+			constexpr bool expected = std::is_same_v<Policy, OkLikely>;
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_expect(is_ok, expected);
+#else
+			(void)expected;
+			return is_ok;
+#endif
+		}
+	}
+} // namespace detail
+
+#endif
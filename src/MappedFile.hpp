@@ -0,0 +1,408 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: MappedFile.hpp
+// Description: Read only memory mapped files, with zero-copy iteration over lines and fixed size
+//              records as borrowed `std::string_view` results
+// =================================
+//
+
+#ifndef OL_MAPPED_FILE_HPP
+#define OL_MAPPED_FILE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define OL_HAS_MMAP 1
+#endif
+
+#include "Assertions.hpp"
+#include "Result.hpp"
+
+/// Why a file could not be mapped, or a record could not be read from it
+struct IoError {
+	enum class Kind : std::uint8_t
+	{
+		open,
+		stat,
+		map,
+		truncated_record,
+		unsupported
+	};
+
+	Kind		kind;
+	/// `errno` of the failed call, 0 for `truncated_record` and `unsupported`
+	int			error_number;
+	/// Offset of the incomplete record for `truncated_record`, 0 otherwise
+	std::size_t offset;
+
+	[[nodiscard]] std::string message(void) const
+	{
+		switch (kind)
+		{
+		case Kind::open: return std::string("open failed: ") + std::strerror(error_number);
+		case Kind::stat: return std::string("fstat failed: ") + std::strerror(error_number);
+		case Kind::map: return std::string("mmap failed: ") + std::strerror(error_number);
+		case Kind::truncated_record:
+			return "incomplete record at offset " + std::to_string(offset);
+		case Kind::unsupported: return "memory mapping is not supported on this platform";
+		}
+		return "unknown error";
+	}
+};
+
+/// Hints given to the kernel when mapping a file
+struct MapOptions {
+	/// The file is read front to back: read ahead aggressively and drop pages behind the reader
+	bool sequential{ true };
+	/// Ask for transparent huge pages. Only honoured by kernels and file systems that support
+	/// them for file backed mappings, ignored otherwise
+	bool huge_pages{ false };
+};
+
+/// A read only view of a whole file.
+/// Everything handed out, the contents, the lines and the records, points into the mapping:
+/// nothing is copied, and nothing outlives the `MappedFile` it came from.
+class MappedFile
+{
+	public:
+
+	/// One line or record: a view into the mapping, or the error reading it, held by value.
+	/// It stays valid after the iterator that produced it moved on or is gone, for as long as
+	/// the `MappedFile` is alive, and unlike `OwningResult` it never allocates.
+	class ViewResult
+	{
+		public:
+
+		using value_type = std::string_view;
+		using error_type = IoError;
+
+		[[nodiscard]] static ViewResult view_ok(std::string_view view) noexcept
+		{
+			return ViewResult(view, IoError{}, true);
+		}
+
+		[[nodiscard]] static ViewResult view_err(const IoError& error) noexcept
+		{
+			return ViewResult(std::string_view{}, error, false);
+		}
+
+		[[nodiscard]] bool is_ok() const noexcept { return m_is_ok; }
+
+		[[nodiscard]] bool is_err() const noexcept { return !m_is_ok; }
+
+		/// Returns a pointer to the view, nullptr if `this` holds an error
+		[[nodiscard]] const std::string_view* peek_ok() const noexcept
+		{
+			return m_is_ok ? &m_view : nullptr;
+		}
+
+		/// Returns a pointer to the error, nullptr if `this` holds a view
+		[[nodiscard]] const IoError* peek_err() const noexcept
+		{
+			return m_is_ok ? nullptr : &m_error;
+		}
+
+		/// Returns the view, interrupts execution with `message` if `this` holds an error
+		std::string_view expect(const std::string_view& message) const
+		{
+			ASSERT(m_is_ok, message);
+			return m_view;
+		}
+
+		/// Returns the view, interrupts execution if `this` holds an error
+		std::string_view unwrap() const
+		{
+			ASSERT(m_is_ok, "");
+			return m_view;
+		}
+
+		/// Returns the error, interrupts execution if `this` holds a view
+		const IoError& unwrap_err() const
+		{
+			ASSERT(!m_is_ok, "");
+			return m_error;
+		}
+
+		private:
+
+		ViewResult(std::string_view view, const IoError& error, bool is_ok) noexcept
+			: m_view{ view },
+			  m_error{ error },
+			  m_is_ok{ is_ok }
+		{
+		}
+
+		std::string_view m_view;
+		IoError			 m_error;
+		bool			 m_is_ok;
+	};
+
+	/// Input range over the lines of a file, without their '\n'.
+	/// A final line without '\n' is still a line, a '\r' before the '\n' is kept.
+	class Lines
+	{
+		public:
+
+		class iterator
+		{
+			public:
+
+			using iterator_concept = std::input_iterator_tag;
+			using value_type	   = ViewResult;
+			using difference_type  = std::ptrdiff_t;
+
+			iterator(void) = default;
+
+			ViewResult operator*(void) const noexcept { return ViewResult::view_ok(m_line); }
+
+			iterator& operator++(void) noexcept
+			{
+				m_rest = m_rest.substr(std::min(m_line.size() + 1, m_rest.size()));
+				m_line = next_line();
+				return *this;
+			}
+
+			void operator++(int) noexcept { ++*this; }
+
+			friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+			{
+				return it.m_line.data() == nullptr;
+			}
+
+			private:
+
+			friend Lines;
+
+			explicit iterator(std::string_view contents) noexcept
+				: m_rest{ contents },
+				  m_line{ next_line() }
+			{
+			}
+
+			[[nodiscard]] std::string_view next_line(void) const noexcept
+			{
+				if (m_rest.empty()) return {};
+				const void* newline = std::memchr(m_rest.data(), '\n', m_rest.size());
+				if (newline == nullptr) return m_rest;
+				return m_rest.substr(0, static_cast<std::size_t>(
+											static_cast<const char*>(newline) - m_rest.data()));
+			}
+
+			std::string_view m_rest;
+			std::string_view m_line;
+		};
+
+		iterator				begin(void) const noexcept { return iterator(m_contents); }
+		std::default_sentinel_t end(void) const noexcept { return {}; }
+
+		private:
+
+		friend MappedFile;
+
+		explicit Lines(std::string_view contents) noexcept : m_contents{ contents } {}
+
+		std::string_view m_contents;
+	};
+
+	/// Input range over consecutive records of `record_size` bytes.
+	/// A trailing partial record is reported as an `IoError::Kind::truncated_record` error.
+	class Records
+	{
+		public:
+
+		class iterator
+		{
+			public:
+
+			using iterator_concept = std::input_iterator_tag;
+			using value_type	   = ViewResult;
+			using difference_type  = std::ptrdiff_t;
+
+			iterator(void) = default;
+
+			ViewResult operator*(void) const noexcept
+			{
+				if (m_record.size() == m_record_size) [[likely]]
+					return ViewResult::view_ok(m_record);
+				const IoError truncated{ IoError::Kind::truncated_record, 0, m_offset };
+				return ViewResult::view_err(truncated);
+			}
+
+			iterator& operator++(void) noexcept
+			{
+				m_offset += m_record_size;
+				load();
+				return *this;
+			}
+
+			void operator++(int) noexcept { ++*this; }
+
+			friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+			{
+				return it.m_offset >= it.m_contents.size();
+			}
+
+			private:
+
+			friend Records;
+
+			iterator(std::string_view contents, std::size_t record_size) noexcept
+				: m_contents{ contents },
+				  m_record_size{ record_size }
+			{
+				load();
+			}
+
+			void load(void) noexcept
+			{
+				if (m_offset >= m_contents.size()) return;
+				m_record = m_contents.substr(m_offset, m_record_size);
+			}
+
+			std::string_view m_contents;
+			std::string_view m_record;
+			std::size_t		 m_record_size{ 0 };
+			std::size_t		 m_offset{ 0 };
+		};
+
+		iterator begin(void) const noexcept { return iterator(m_contents, m_record_size); }
+		std::default_sentinel_t end(void) const noexcept { return {}; }
+
+		private:
+
+		friend MappedFile;
+
+		Records(std::string_view contents, std::size_t record_size) noexcept
+			: m_contents{ contents },
+			  m_record_size{ record_size }
+		{
+		}
+
+		std::string_view m_contents;
+		std::size_t		 m_record_size;
+	};
+
+	/// Opens and maps `path` read only.
+	/// Failing to open, stat or map the file is reported as an `IoError`, never thrown.
+	[[nodiscard]] static OwningResult<MappedFile, IoError> open(
+		const std::filesystem::path& path, MapOptions options = {})
+	{
+#ifdef OL_HAS_MMAP
+		int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (descriptor < 0) return OwningErr<IoError>(IoError{ IoError::Kind::open, errno, 0 });
+
+		struct stat status;
+		if (::fstat(descriptor, &status) != 0)
+		{
+			IoError error{ IoError::Kind::stat, errno, 0 };
+			::close(descriptor);
+			return OwningErr<IoError>(std::move(error));
+		}
+
+		// mmap rejects empty mappings, an empty file is simply empty contents
+		auto size = static_cast<std::size_t>(status.st_size);
+		if (size == 0)
+		{
+			::close(descriptor);
+			return OwningOk<MappedFile>(MappedFile(nullptr, 0));
+		}
+
+		void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		// The mapping keeps the file alive, the descriptor is not needed any more
+		IoError error{ IoError::Kind::map, errno, 0 };
+		::close(descriptor);
+		if (data == MAP_FAILED) return OwningErr<IoError>(std::move(error));
+
+		// Hints are advisory, a kernel that does not know one is no reason to fail
+		if (options.sequential) (void)::madvise(data, size, MADV_SEQUENTIAL);
+#  ifdef MADV_HUGEPAGE
+		if (options.huge_pages) (void)::madvise(data, size, MADV_HUGEPAGE);
+#  endif
+		return OwningOk<MappedFile>(MappedFile(static_cast<const char*>(data), size));
+#else
+		(void)path;
+		(void)options;
+		return OwningErr<IoError>(IoError{ IoError::Kind::unsupported, 0, 0 });
+#endif
+	}
+
+	MappedFile(MappedFile&& other) noexcept
+		: m_data{ std::exchange(other.m_data, nullptr) },
+		  m_size{ std::exchange(other.m_size, 0) }
+	{
+	}
+
+	MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+		}
+		return *this;
+	}
+
+	MappedFile(const MappedFile&)			 = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile(void) { unmap(); }
+
+	[[nodiscard]] const char* data(void) const noexcept { return m_data; }
+
+	[[nodiscard]] std::size_t size(void) const noexcept { return m_size; }
+
+	[[nodiscard]] std::string_view contents(void) const noexcept { return { m_data, m_size }; }
+
+	[[nodiscard]] Lines lines(void) const noexcept { return Lines(contents()); }
+
+	[[nodiscard]] Records records(std::size_t record_size) const
+	{
+		ASSERT(record_size > 0, "records need a size of at least one byte");
+		return Records(contents(), record_size);
+	}
+
+	private:
+
+	MappedFile(const char* data, std::size_t size) noexcept : m_data{ data }, m_size{ size } {}
+
+	void unmap(void) noexcept
+	{
+#ifdef OL_HAS_MMAP
+		if (m_data != nullptr) ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+	}
+
+	const char* m_data;
+	std::size_t m_size;
+};
+
+#endif
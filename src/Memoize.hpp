@@ -0,0 +1,400 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: Memoize.hpp
+// Description: A bounded, sharded, thread safe memoization cache for functions returning
+//              `OwningResult<T, E>`, with negative caching of errors and single-flight misses
+// =================================
+//
+
+#ifndef OL_MEMOIZE_HPP
+#define OL_MEMOIZE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "Result.hpp"
+
+struct MemoizeConfig {
+	/// Number of independently locked shards keys are spread over
+	std::size_t num_shards{ 16 };
+	/// Maximum number of cached Ok values, over all shards.
+	/// It is split as evenly as possible, so with fewer than `num_shards` some shards cache none
+	std::size_t ok_capacity{ 4096 };
+	/// Maximum number of cached Err values, over all shards, split like `ok_capacity`;
+	/// 0 disables negative caching
+	std::size_t err_capacity{ 1024 };
+	/// How long an Err value is served from the cache before the function is retried
+	std::chrono::steady_clock::duration err_ttl{ std::chrono::seconds(1) };
+};
+
+struct MemoizeStats {
+	/// Calls answered with a cached Ok value
+	std::uint64_t hits{ 0 };
+	/// Calls answered with a cached Err value
+	std::uint64_t negative_hits{ 0 };
+	/// Calls that ran the function
+	std::uint64_t misses{ 0 };
+	/// Calls that waited for another thread already running the function for the same key
+	std::uint64_t coalesced{ 0 };
+	/// Cached values dropped to make room, Ok and Err
+	std::uint64_t evictions{ 0 };
+};
+
+namespace detail
+{
+	/// Fixed capacity key-value table with CLOCK (second chance) eviction.
+	/// `find` may run concurrently with other `find`s, everything else needs exclusive access.
+	template<typename Key, typename Value, typename Hash>
+	class ClockTable
+	{
+		public:
+
+		using Clock = std::chrono::steady_clock;
+
+		explicit ClockTable(std::size_t capacity)
+			: m_capacity{ capacity },
+			  m_slots{ std::make_unique<Slot[]>(capacity) }
+		{
+			m_index.reserve(capacity);
+		}
+
+		[[nodiscard]] std::size_t capacity(void) const noexcept { return m_capacity; }
+
+		/// Returns the value stored for `key`, nullptr if there is none or it expired before `now`
+		[[nodiscard]] const Value* find(const Key& key, Clock::time_point now) const
+		{
+			auto found = m_index.find(key);
+			if (found == m_index.end()) return nullptr;
+			const Slot& slot = m_slots[found->second];
+			if (slot.expiry < now) return nullptr;
+			slot.referenced.store(true, std::memory_order_relaxed);
+			return &*slot.value;
+		}
+
+		/// Stores `value` for `key` until `expiry`, returns true if another entry was evicted
+		bool insert(const Key& key, Value&& value, Clock::time_point expiry)
+		{
+			if (m_capacity == 0) return false;
+			auto found = m_index.find(key);
+			if (found != m_index.end())
+			{
+				Slot& slot = m_slots[found->second];
+				slot.value.emplace(std::move(value));
+				slot.expiry = expiry;
+				return false;
+			}
+
+			bool		evicted = false;
+			std::size_t index	= m_size;
+			if (m_size < m_capacity) ++m_size;
+			else
+			{
+				index = sweep();
+				m_index.erase(*m_slots[index].key);
+				evicted = true;
+			}
+			Slot& slot = m_slots[index];
+			slot.key.emplace(key);
+			slot.value.emplace(std::move(value));
+			slot.expiry = expiry;
+			slot.referenced.store(false, std::memory_order_relaxed);
+			m_index.emplace(key, index);
+			return evicted;
+		}
+
+		void clear(void)
+		{
+			m_index.clear();
+			for (std::size_t i = 0; i < m_size; ++i)
+			{
+				m_slots[i].key.reset();
+				m_slots[i].value.reset();
+			}
+			m_size = 0;
+			m_hand = 0;
+		}
+
+		private:
+
+		struct Slot {
+			std::optional<Key>		  key;
+			std::optional<Value>	  value;
+			Clock::time_point		  expiry{};
+			mutable std::atomic<bool> referenced{ false };
+		};
+
+		// Advances the hand past recently referenced slots, clearing their bit as it goes, and
+		// returns the first slot that was not referenced since the last sweep or has expired
+		std::size_t sweep(void)
+		{
+			Clock::time_point now = Clock::now();
+			while (true)
+			{
+				Slot&		slot  = m_slots[m_hand];
+				std::size_t index = m_hand;
+				m_hand			  = m_hand + 1 == m_capacity ? 0 : m_hand + 1;
+				bool referenced = slot.referenced.exchange(false, std::memory_order_relaxed);
+				if (slot.expiry < now || !referenced) return index;
+			}
+		}
+
+		std::size_t								   m_capacity;
+		std::unique_ptr<Slot[]>					   m_slots;
+		std::unordered_map<Key, std::size_t, Hash> m_index;
+		std::size_t								   m_size{ 0 };
+		std::size_t								   m_hand{ 0 };
+	};
+} // namespace detail
+
+/// Memoizes `func`, see `memoize`.
+/// Calls for different keys run concurrently. A call that finds its key being computed by another
+/// thread waits for that computation instead of starting its own.
+template<typename Key, typename T, typename E, typename Hash = std::hash<Key>>
+class MemoizedFunction
+{
+	public:
+
+	static_assert(std::is_copy_constructible_v<T> && std::is_copy_constructible_v<E>,
+				  "cached values are handed out as copies");
+
+	using Function = std::function<OwningResult<T, E>(const Key&)>;
+
+	explicit MemoizedFunction(Function&& func, MemoizeConfig config = {})
+		: m_func{ std::move(func) },
+		  m_config{ config },
+		  m_num_shards{ std::max<std::size_t>(config.num_shards, 1) },
+		  m_shards{ std::make_unique<Shard[]>(m_num_shards) }
+	{
+		for (std::size_t i = 0; i < m_num_shards; ++i)
+		{
+			m_shards[i].ok_values.emplace(shard_capacity(config.ok_capacity, i));
+			m_shards[i].err_values.emplace(shard_capacity(config.err_capacity, i));
+		}
+	}
+
+	/// Returns the cached result for `key`, or calls the function and caches what it returns.
+	/// If the function throws, the exception reaches every caller waiting on that key and nothing
+	/// is cached.
+	OwningResult<T, E> operator()(const Key& key)
+	{
+		Shard&			  shard = shard_for(key);
+		Clock::time_point now	= Clock::now();
+		{
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+			if (auto cached = lookup(shard, key, now)) return std::move(*cached);
+		}
+
+		std::shared_ptr<Flight> flight;
+		bool					leader = false;
+		{
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			if (auto cached = lookup(shard, key, now)) return std::move(*cached);
+			auto [position, inserted] = shard.in_flight.try_emplace(key);
+			if (inserted) position->second = std::make_shared<Flight>();
+			flight = position->second;
+			leader = inserted;
+		}
+
+		if (!leader)
+		{
+			shard.coalesced.fetch_add(1, std::memory_order_relaxed);
+			return flight->wait();
+		}
+
+		shard.misses.fetch_add(1, std::memory_order_relaxed);
+		try
+		{
+			OwningResult<T, E> result = m_func(key);
+			flight->set(result);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			store(shard, key, flight);
+			shard.in_flight.erase(key);
+		}
+		catch (...)
+		{
+			flight->fail(std::current_exception());
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			shard.in_flight.erase(key);
+			throw;
+		}
+		return flight->wait();
+	}
+
+	/// Sums the statistics of every shard, the counts are only approximate while calls run
+	[[nodiscard]] MemoizeStats stats(void) const
+	{
+		MemoizeStats total;
+		for (std::size_t i = 0; i < m_num_shards; ++i)
+		{
+			const Shard& shard = m_shards[i];
+			total.hits += shard.hits.load(std::memory_order_relaxed);
+			total.negative_hits += shard.negative_hits.load(std::memory_order_relaxed);
+			total.misses += shard.misses.load(std::memory_order_relaxed);
+			total.coalesced += shard.coalesced.load(std::memory_order_relaxed);
+			total.evictions += shard.evictions.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+
+	/// Drops every cached value, calls in flight are not affected
+	void clear(void)
+	{
+		for (std::size_t i = 0; i < m_num_shards; ++i)
+		{
+			std::unique_lock<std::shared_mutex> lock(m_shards[i].mutex);
+			m_shards[i].ok_values->clear();
+			m_shards[i].err_values->clear();
+		}
+	}
+
+	private:
+
+	using Clock = std::chrono::steady_clock;
+
+	// The outcome of one call of the function, shared by the caller that ran it and every caller
+	// that waited for it
+	class Flight
+	{
+		public:
+
+		void set(OwningResult<T, E>& result)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (result.is_ok()) m_value.emplace(result.unwrap());
+			else m_error.emplace(*result.err());
+			m_done = true;
+			m_done_signal.notify_all();
+		}
+
+		void fail(std::exception_ptr exception)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_exception = std::move(exception);
+			m_done		= true;
+			m_done_signal.notify_all();
+		}
+
+		OwningResult<T, E> wait(void)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done_signal.wait(lock, [this]() { return m_done; });
+			if (m_exception) std::rethrow_exception(m_exception);
+			if (m_value) return OwningOk<T>(T(*m_value));
+			return OwningErr<E>(E(*m_error));
+		}
+
+		// Only called once `set` has returned, by the thread that called it
+		const std::optional<T>& value(void) const noexcept { return m_value; }
+		const std::optional<E>& error(void) const noexcept { return m_error; }
+
+		private:
+
+		std::mutex				m_mutex;
+		std::condition_variable m_done_signal;
+		bool					m_done{ false };
+		std::optional<T>		m_value;
+		std::optional<E>		m_error;
+		std::exception_ptr		m_exception;
+	};
+
+	// Aligned so the statistics counters of neighbouring shards do not share a cache line
+	struct alignas(64) Shard {
+		std::shared_mutex									   mutex;
+		std::optional<detail::ClockTable<Key, T, Hash>>		   ok_values;
+		std::optional<detail::ClockTable<Key, E, Hash>>		   err_values;
+		std::unordered_map<Key, std::shared_ptr<Flight>, Hash> in_flight;
+		std::atomic<std::uint64_t>							   hits{ 0 };
+		std::atomic<std::uint64_t>							   negative_hits{ 0 };
+		std::atomic<std::uint64_t>							   misses{ 0 };
+		std::atomic<std::uint64_t>							   coalesced{ 0 };
+		std::atomic<std::uint64_t>							   evictions{ 0 };
+	};
+
+	// The first `total % m_num_shards` shards take one entry more, so the shares add up to `total`
+	[[nodiscard]] std::size_t shard_capacity(std::size_t total, std::size_t shard) const noexcept
+	{
+		return total / m_num_shards + (shard < total % m_num_shards ? 1 : 0);
+	}
+
+	Shard& shard_for(const Key& key)
+	{
+		// The low bits of std::hash are often the key itself, mix before picking a shard
+		std::uint64_t hash = static_cast<std::uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ULL;
+		return m_shards[(hash >> 32) % m_num_shards];
+	}
+
+	// Needs at least shared access to `shard`
+	std::optional<OwningResult<T, E>> lookup(Shard& shard, const Key& key, Clock::time_point now)
+	{
+		if (const T* value = shard.ok_values->find(key, Clock::time_point::max()))
+		{
+			shard.hits.fetch_add(1, std::memory_order_relaxed);
+			return OwningResult<T, E>(OwningOk<T>(T(*value)));
+		}
+		if (const E* error = shard.err_values->find(key, now))
+		{
+			shard.negative_hits.fetch_add(1, std::memory_order_relaxed);
+			return OwningResult<T, E>(OwningErr<E>(E(*error)));
+		}
+		return std::nullopt;
+	}
+
+	// Needs exclusive access to `shard`
+	void store(Shard& shard, const Key& key, const std::shared_ptr<Flight>& flight)
+	{
+		bool evicted = false;
+		if (flight->value())
+			evicted = shard.ok_values->insert(key, T(*flight->value()), Clock::time_point::max());
+		else
+			evicted = shard.err_values->insert(key, E(*flight->error()),
+											   Clock::now() + m_config.err_ttl);
+		if (evicted) shard.evictions.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Function				   m_func;
+	MemoizeConfig			   m_config;
+	std::size_t				   m_num_shards;
+	std::unique_ptr<Shard[]>   m_shards;
+	[[no_unique_address]] Hash m_hash;
+};
+
+/// Wraps `func`, a function from `Key` to `OwningResult<T, E>`, in a cache.
+/// Ok values are kept until evicted by CLOCK once `config.ok_capacity` is reached. Err values
+/// are cached separately, up to `config.err_capacity` of them and each for `config.err_ttl`, so
+/// a failing key is not retried at full cost on every call but is retried eventually.
+template<typename Key, typename T, typename E, typename Hash = std::hash<Key>, typename Func>
+[[nodiscard]] MemoizedFunction<Key, T, E, Hash> memoize(Func&& func, MemoizeConfig config = {})
+{
+	return MemoizedFunction<Key, T, E, Hash>(
+		typename MemoizedFunction<Key, T, E, Hash>::Function(std::forward<Func>(func)), config);
+}
+
+#endif
@@ -0,0 +1,250 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: MultiErr.hpp
+// Description: An error type that collects many errors with bounded allocation, and the
+//              `validate_all` combinator that fills it from a batch of results
+// =================================
+//
+
+#ifndef OL_MULTI_ERR_HPP
+#define OL_MULTI_ERR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Assertions.hpp"
+#include "Result.hpp"
+
+/// Collects errors for batch validation.
+/// The first `N` errors are stored inline. Further errors are appended to a `std::pmr::vector`
+/// allocated from `arena` when one is given, and only counted otherwise. Without an arena,
+/// a `MultiErr` never allocates, however many errors it is given.
+template<typename E, std::size_t N>
+class MultiErr
+{
+	public:
+
+	static_assert(N > 0, "MultiErr needs room for at least one inline error");
+
+	using value_type = E;
+
+	/// Index based iterator over the inline errors followed by the spilled ones
+	template<bool Const>
+	class Iterator
+	{
+		public:
+
+		using owner_type		= std::conditional_t<Const, const MultiErr, MultiErr>;
+		using iterator_category = std::forward_iterator_tag;
+		using value_type		= E;
+		using difference_type	= std::ptrdiff_t;
+		using reference			= std::conditional_t<Const, const E&, E&>;
+
+		Iterator(void) = default;
+		Iterator(owner_type* owner, std::size_t index) noexcept
+			: m_owner{ owner },
+			  m_index{ index }
+		{
+		}
+
+		reference operator*(void) const { return (*m_owner)[m_index]; }
+
+		Iterator& operator++(void) noexcept
+		{
+			++m_index;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++m_index;
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const noexcept { return m_index == other.m_index; }
+
+		private:
+
+		owner_type* m_owner{ nullptr };
+		std::size_t m_index{ 0 };
+	};
+
+	using iterator		 = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	/// Only counts errors beyond the first `N`
+	MultiErr(void) noexcept : m_spilled{ std::pmr::null_memory_resource() } {}
+
+	/// Spills errors beyond the first `N` to `arena`, which must outlive this `MultiErr`
+	explicit MultiErr(std::pmr::memory_resource* arena) noexcept
+		: m_spilled{ arena != nullptr ? arena : std::pmr::null_memory_resource() },
+		  m_can_spill{ arena != nullptr }
+	{
+	}
+
+	MultiErr(MultiErr&& other) noexcept(std::is_nothrow_move_constructible_v<E>)
+		: m_inline_count{ other.m_inline_count },
+		  m_spilled{ std::move(other.m_spilled) },
+		  m_dropped{ other.m_dropped },
+		  m_can_spill{ other.m_can_spill }
+	{
+		for (std::size_t i = 0; i < m_inline_count; ++i)
+			::new (static_cast<void*>(slot(i))) E(std::move(*other.inline_at(i)));
+		other.clear();
+	}
+
+	MultiErr& operator=(MultiErr&&) = delete;
+	MultiErr(const MultiErr&)		= delete;
+	MultiErr& operator=(const MultiErr&) = delete;
+
+	~MultiErr(void) { clear(); }
+
+	/// Adds an error. Returns false if it was only counted because there was no room for it.
+	bool push(E&& error)
+	{
+		if (m_inline_count < N) [[likely]]
+		{
+			::new (static_cast<void*>(slot(m_inline_count))) E(std::move(error));
+			++m_inline_count;
+			return true;
+		}
+		if (m_can_spill)
+		{
+			m_spilled.push_back(std::move(error));
+			return true;
+		}
+		++m_dropped;
+		return false;
+	}
+
+	/// Number of errors stored, inline and spilled
+	[[nodiscard]] std::size_t size(void) const noexcept
+	{
+		return m_inline_count + m_spilled.size();
+	}
+
+	/// Number of errors that were counted but not stored
+	[[nodiscard]] std::size_t dropped(void) const noexcept { return m_dropped; }
+
+	/// Number of errors pushed, stored or not
+	[[nodiscard]] std::size_t total(void) const noexcept { return size() + m_dropped; }
+
+	[[nodiscard]] bool empty(void) const noexcept { return total() == 0; }
+
+	E& operator[](std::size_t index)
+	{
+		ASSERT(index < size(), "MultiErr index out of range");
+		return index < N ? *inline_at(index) : m_spilled[index - N];
+	}
+
+	const E& operator[](std::size_t index) const
+	{
+		ASSERT(index < size(), "MultiErr index out of range");
+		return index < N ? *inline_at(index) : m_spilled[index - N];
+	}
+
+	iterator	   begin(void) noexcept { return iterator(this, 0); }
+	iterator	   end(void) noexcept { return iterator(this, size()); }
+	const_iterator begin(void) const noexcept { return const_iterator(this, 0); }
+	const_iterator end(void) const noexcept { return const_iterator(this, size()); }
+
+	/// Destroys every stored error and resets the counts, the arena is kept
+	void clear(void) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible_v<E>)
+			for (std::size_t i = 0; i < m_inline_count; ++i)
+				inline_at(i)->~E();
+		m_inline_count = 0;
+		m_spilled.clear();
+		m_dropped = 0;
+	}
+
+	private:
+
+	void* slot(std::size_t index) noexcept { return m_storage + index * sizeof(E); }
+
+	E* inline_at(std::size_t index) noexcept
+	{
+		return std::launder(reinterpret_cast<E*>(m_storage + index * sizeof(E)));
+	}
+
+	const E* inline_at(std::size_t index) const noexcept
+	{
+		return std::launder(reinterpret_cast<const E*>(m_storage + index * sizeof(E)));
+	}
+
+	alignas(E) std::byte m_storage[N * sizeof(E)];
+	std::size_t			 m_inline_count{ 0 };
+	std::pmr::vector<E>	 m_spilled;
+	std::size_t			 m_dropped{ 0 };
+	bool				 m_can_spill{ false };
+};
+
+/// https://doc.rust-lang.org/std/iter/trait.Iterator.html#method.collect for `Result`, except
+/// that every error is kept rather than only the first.
+/// Consumes the errors of `results`, the Ok values are left in place.
+template<std::size_t N, std::ranges::input_range Range>
+[[nodiscard]] auto validate_all(Range&& results, std::pmr::memory_resource* arena = nullptr)
+{
+	using Result = std::ranges::range_value_t<Range>;
+	using E		 = typename Result::error_type;
+	using Status = OwningResult<void,
+								MultiErr<E, N>,
+								typename Result::likelihood_policy,
+								typename Result::checking_policy>;
+
+	MultiErr<E, N> errors(arena);
+	for (auto&& result : results)
+		if (result.is_err()) errors.push(*result.err());
+	if (errors.empty()) return Status(OwningOk<void>());
+	return Status(std::move(errors));
+}
+
+/// Runs `validator` on every element of `inputs` and collects the errors it returns.
+/// `validator` returns any `OwningResult` with error type `E`, preferably `OwningResult<void, E>`
+/// which costs no allocation per element.
+template<std::size_t N, std::ranges::input_range Range, typename Validator>
+[[nodiscard]] auto validate_all(Range&&					   inputs,
+								Validator&&				   validator,
+								std::pmr::memory_resource* arena = nullptr)
+{
+	using Result = std::invoke_result_t<Validator&, std::ranges::range_reference_t<Range>>;
+	using E		 = typename Result::error_type;
+	using Status = OwningResult<void,
+								MultiErr<E, N>,
+								typename Result::likelihood_policy,
+								typename Result::checking_policy>;
+
+	MultiErr<E, N> errors(arena);
+	for (auto&& input : inputs)
+	{
+		Result result = validator(input);
+		if (result.is_err()) errors.push(*result.err());
+	}
+	if (errors.empty()) return Status(OwningOk<void>());
+	return Status(std::move(errors));
+}
+
+#endif
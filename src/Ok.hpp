@@ -35,6 +35,7 @@
 
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 /// A generic type that can be used to initialize the Ok classes
 template<typename T>
@@ -62,11 +63,10 @@ class OwningOk
 	{
 		if constexpr (std::is_pointer<T>::value)
 		{
-			m_stored_value = std::make_unique<underlying_type>();
 			m_stored_value.reset(value);
 			value = nullptr;
 		}
-		else { m_stored_value = std::make_unique<underlying_type>(value); }
+		else { m_stored_value = std::make_unique<underlying_type>(std::move(value)); }
 	}
 
 	template<typename U>
@@ -76,16 +76,64 @@ class OwningOk
 
 	OwningOk(VoidOk<T>) noexcept : m_stored_value{} {}
 
-	underlying_type& get(void) { return *m_stored_value.release(); }
+	underlying_type& get(void) { return *m_stored_value; }
 
 	[[nodiscard]] underlying_type* release(void) { return m_stored_value.release(); }
 
+	/// Read only access to the stored value without giving up ownership, nullptr if empty
+	[[nodiscard]] const underlying_type* peek(void) const noexcept { return m_stored_value.get(); }
+
 	private:
 
 	// pointer to stored information
 	std::unique_ptr<underlying_type> m_stored_value;
 };
 
+/// OwningOk for types without state, e.g. tag types.
+/// There is nothing worth a heap allocation, so the value is stored inline and takes no space
+/// in an enclosing `[[no_unique_address]]` member.
+/// Only default constructible types qualify, `VoidOk<T>` has to conjure one up; the others are
+/// boxed like any other type.
+template<typename T>
+	requires(std::is_empty_v<T> && std::is_default_constructible_v<T>)
+class OwningOk<T>
+{
+	public:
+
+	using underlying_type = T;
+
+	OwningOk() = default;
+
+	OwningOk(T&& value) noexcept : m_stored_value{ std::move(value) } {}
+
+	OwningOk(VoidOk<T>) noexcept : m_stored_value{} {}
+
+	underlying_type& get(void) { return m_stored_value; }
+
+	/// Nothing was allocated that could be handed over, move the value out of `get()` instead
+	underlying_type* release(void) = delete;
+
+	/// Never nullptr, there is always a value without state to look at
+	[[nodiscard]] const underlying_type* peek(void) const noexcept { return &m_stored_value; }
+
+	private:
+
+	[[no_unique_address]] T m_stored_value;
+};
+
+/// OwningOk<void> only marks success, there is no value to own
+template<>
+class OwningOk<void>
+{
+	public:
+
+	using underlying_type = void;
+
+	OwningOk() = default;
+
+	OwningOk(VoidOk<void>) noexcept {}
+};
+
 /// NonowningOk only takes by reference and only stores a reference.
 /// The user should ensure that the lifetime of the object does not terminate before the instance
 /// of the NonowningOk has terminated, otherwise you would be accessing a nullptr
@@ -23,6 +23,7 @@
 #ifndef OL_RESULT_HPP
 #define OL_RESULT_HPP
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -31,10 +32,15 @@
 
 #include "Assertions.hpp"
 #include "Err.hpp"
+#include "Checking.hpp"
+#include "Likelihood.hpp"
 #include "Ok.hpp"
 
 // Forward declarations
-template<typename T, typename E>
+template<typename T,
+		 typename E,
+		 LikelihoodPolicy Likelihood = OkLikely,
+		 CheckingPolicy	  Checking	 = DefaultChecking>
 class OwningResult;
 template<typename T, typename E>
 class NonowningResult;
@@ -45,49 +51,80 @@ class NonowningResult;
 
 /// OwningResult employes the OwningOk and OwningErr data structures which take r-value references
 /// only.
-template<typename T, typename E>
+/// `Likelihood` is `OkLikely`, `ErrLikely` or `Neutral`, see Likelihood.hpp. It decides which side
+/// of every Ok/Err branch the compiler lays out as the fall through, keeping the other side off
+/// the hot path's cache lines.
+/// `Checking` is `FullChecks`, `LightChecks` or `NoChecks`, see Checking.hpp. Below full checks
+/// the consumed flag is not stored, and `ok()`, `err()`, `expect()` and `unwrap()` do not test it.
+template<typename T, typename E, LikelihoodPolicy Likelihood, CheckingPolicy Checking>
 class OwningResult
 {
 	friend NonowningResult<T, E>;
 
 	public:
 
+	using value_type		= T;
+	using error_type		= E;
+	using likelihood_policy = Likelihood;
+	using checking_policy	= Checking;
+
 	OwningResult(OwningOk<T>&& ok) noexcept : m_is_ok{ true },
-											  m_is_consumed{ false },
+											  m_consumed{ false },
 											  m_value{ std::move(ok) },
 											  m_err{ VoidErr<E>() }
 	{
 	}
 
 	OwningResult(OwningErr<E>&& err) noexcept : m_is_ok{ false },
-												m_is_consumed{ false },
+												m_consumed{ false },
 												m_value{ VoidOk<T>() },
 												m_err{ std::move(err) }
 	{
 	}
 
+	/// Takes over the stored side. Under `FullChecks` the source counts as consumed afterwards, so
+	/// using it asserts, or answers nothing, instead of reaching into the emptied box
+	OwningResult(OwningResult&& other) noexcept : m_is_ok{ other.m_is_ok },
+												  m_consumed{ other.m_consumed.is_set() },
+												  m_value{ std::move(other.m_value) },
+												  m_err{ std::move(other.m_err) }
+	{
+		other.m_consumed.set();
+	}
+
+	OwningResult& operator=(OwningResult&& other) noexcept
+	{
+		if (this == &other) return *this;
+		m_is_ok	   = other.m_is_ok;
+		m_consumed = other.m_consumed;
+		m_value	   = std::move(other.m_value);
+		m_err	   = std::move(other.m_err);
+		other.m_consumed.set();
+		return *this;
+	}
+
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_ok
 	/// Returns true if `OwningResult<T, E>` has `OwningOk<T> != VoidOk<T>`
-	[[nodiscard]] bool is_ok() { return m_is_ok; }
+	[[nodiscard]] bool is_ok() const noexcept { return detail::predict_ok<Likelihood>(m_is_ok); }
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_ok_and
 	/// Returns true if the result is `OwningOk<T>` and the value inside of it matches a predicate
 	[[nodiscard]] bool is_ok_and(std::function<bool(T&)> func)
 	{
-		if (m_is_ok && func(m_value.get())) return true;
+		if (detail::predict_ok<Likelihood>(m_is_ok)) return func(m_value.get());
 		else return false;
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_err
 	/// Returns true `OwningResult<T, E>` has `OwningErr<E> != VoidErr<E>`
-	[[nodiscard]] bool is_err() { return !m_is_ok; }
+	[[nodiscard]] bool is_err() const noexcept { return !detail::predict_ok<Likelihood>(m_is_ok); }
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_ok_and
 	/// Returns true if the result is `OwningErr<E>` and the value inside of it matches a predicate
-	[[nodiscard]] bool is_err_and(std::function<bool(T&)> func)
+	[[nodiscard]] bool is_err_and(std::function<bool(E&)> func)
 	{
-		if (!m_is_ok && func(m_err.get())) return true;
-		else return false;
+		if (detail::predict_ok<Likelihood>(m_is_ok)) return false;
+		else return func(m_err.get());
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.ok
@@ -95,11 +132,11 @@ class OwningResult
 	/// Consumes instance of `OwningOk<T>`, discarding the error
 	[[nodiscard]] std::optional<T> ok()
 	{
-		if (m_is_consumed) return std::nullopt;
-		if (m_is_ok)
+		if (m_consumed.is_set()) return std::nullopt;
+		if (detail::predict_ok<Likelihood>(m_is_ok))
 		{
-			m_is_consumed = true;
-			return std::optional<T>(m_value.release());
+			m_consumed.set();
+			return std::optional<T>(take_value());
 		}
 		else return std::nullopt;
 	}
@@ -107,15 +144,29 @@ class OwningResult
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.err
 	/// Converts from `OwningResult<T, E>` to `std::option<E>`
 	/// Consumes instance of `OwningErr<E>`, discarding the error
-	[[nodiscard]] std::optional<T> err()
+	[[nodiscard]] std::optional<E> err()
 	{
-		if (m_is_consumed) return std::nullopt;
-		if (!m_is_ok)
+		if (m_consumed.is_set()) return std::nullopt;
+		if (detail::predict_ok<Likelihood>(m_is_ok)) return std::nullopt;
+		else
 		{
-			m_is_consumed = true;
-			return std::optional<T>(m_err.release());
+			m_consumed.set();
+			return std::optional<E>(take_error());
 		}
-		else return std::nullopt;
+	}
+
+	/// Returns a pointer to the contained `OwningOk<T>` value without consuming it.
+	/// Returns nullptr if `this` holds an `OwningErr<E>` or has already been consumed
+	[[nodiscard]] const typename OwningOk<T>::underlying_type* peek_ok() const noexcept
+	{
+		return (m_is_ok && !m_consumed.is_set()) ? m_value.peek() : nullptr;
+	}
+
+	/// Returns a pointer to the contained `OwningErr<E>` value without consuming it.
+	/// Returns nullptr if `this` holds an `OwningOk<T>` or has already been consumed
+	[[nodiscard]] const typename OwningErr<E>::underlying_type* peek_err() const noexcept
+	{
+		return (!m_is_ok && !m_consumed.is_set()) ? m_err.peek() : nullptr;
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.as_ref
@@ -126,15 +177,16 @@ class OwningResult
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map
 	/// Maps a `OwningResult<T, E>` to a `OwningResult<U, E>` by applying a function to a
 	/// `OwningOk<T>` value, leaving the Err value untouched
+	/// Consumes `this`
 	template<typename U>
-	[[nodiscard]] OwningResult<U, E> map(std::function<U(T&)>&& func)
+	[[nodiscard]] OwningResult<U, E, Likelihood, Checking> map(std::function<U(T&)>&& func)
 	{
-		if (m_is_ok)
-		{
-			auto new_ok = OwninOk<U>(*std::move(func(m_value.get())));
-			return OwningResult<U, E>(std::move(new_ok));
-		}
-		else { return OwningResult<U, E>(m_err); }
+		using Mapped = OwningResult<U, E, Likelihood, Checking>;
+		check_not_consumed("map called on a consumed OwningResult");
+		m_consumed.set();
+		if (detail::predict_ok<Likelihood>(m_is_ok))
+			return Mapped(OwningOk<U>(func(m_value.get())));
+		else return Mapped(std::move(m_err));
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map_or
@@ -143,7 +195,7 @@ class OwningResult
 	template<typename U>
 	[[nodiscard]] U map_or(U default_value, std::function<U(T&)>&& func)
 	{
-		if (m_is_ok) return func(m_value.get());
+		if (detail::predict_ok<Likelihood>(m_is_ok)) return func(m_value.get());
 		else return default_value;
 	}
 
@@ -153,22 +205,22 @@ class OwningResult
 	template<typename U>
 	[[nodiscard]] U map_or_else(std::function<U(E&)>&& default_mapper, std::function<U(T&)>&& func)
 	{
-		if (m_is_ok) return func(m_value.get());
+		if (detail::predict_ok<Likelihood>(m_is_ok)) return func(m_value.get());
 		else return default_mapper(m_err.get());
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map
 	/// Maps a `OwningResult<T, E>` to a `OwningResult<T, F>` by applying a function to a
 	/// `OwningErr<E>` value, leaving the Err value untouched
+	/// Consumes `this`
 	template<typename F>
-	[[nodiscard]] OwningResult<T, F> map_err(std::function<F(E&)>&& func)
+	[[nodiscard]] OwningResult<T, F, Likelihood, Checking> map_err(std::function<F(E&)>&& func)
 	{
-		if (!m_is_ok)
-		{
-			auto new_err = OwninErr<F>(*std::move(func(m_err.get())));
-			return OwningResult<T, F>(std::move(new_err));
-		}
-		else { return OwningResult<T, F>(m_value); }
+		using Mapped = OwningResult<T, F, Likelihood, Checking>;
+		check_not_consumed("map_err called on a consumed OwningResult");
+		m_consumed.set();
+		if (detail::predict_ok<Likelihood>(m_is_ok)) return Mapped(std::move(m_value));
+		else return Mapped(OwningErr<F>(func(m_err.get())));
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.inspect
@@ -176,9 +228,10 @@ class OwningResult
 	/// In general, this call should not be used to create a new `OwningResult<T, E>`
 	/// or `NonwningResult<T, E>` type
 	template<typename ReturnType>
-	OwningResult<T, E>& inspect(std::function<ReturnType(OwningOk<T>&)> func)
+	OwningResult& inspect(std::function<ReturnType(OwningOk<T>&)> func)
 	{
-		if (m_is_ok) func(m_value);
+		if (detail::predict_ok<Likelihood>(m_is_ok))
+			func(m_value);
 		return *this;
 	}
 
@@ -187,9 +240,10 @@ class OwningResult
 	/// In general, this call should not be used to create a new `OwningResult<T, E>`
 	/// or `NonwningResult<T, E>` type
 	template<typename ReturnType>
-	OwningResult<T, E>& inspect_err(std::function<ReturnType(OwningOk<T>&)> func)
+	OwningResult& inspect_err(std::function<ReturnType(OwningErr<E>&)> func)
 	{
-		if (!m_is_ok) func(m_value);
+		if (!detail::predict_ok<Likelihood>(m_is_ok))
+			func(m_err);
 		return *this;
 	}
 
@@ -211,8 +265,9 @@ class OwningResult
 	/// `unwrap_of_else`, or `unwrap_of_default`.
 	T expect(const std::string_view& message)
 	{
-		ASSERT(!m_is_consumed, message);
-		return m_value.release();
+		check_ok(message);
+		m_consumed.set();
+		return take_value();
 	}
 
 	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.unwrap
@@ -222,18 +277,423 @@ class OwningResult
 	/// preferred for your to use `unwrap_or`, `unwrap_of_else`, or `unwrap_of_default`.
 	T unwrap()
 	{
-		ASSERT(!m_is_consumed, "");
-		return m_value.release();
+		// The failure path ends in std::terminate, which is cold whatever `Likelihood` says
+		check_ok("");
+		m_consumed.set();
+		return take_value();
+	}
+
+	private:
+
+	OwningResult() = delete;
+
+	// Interrupts execution unless `this` holds a value that was not consumed yet, as far as
+	// `Checking` looks
+	void check_ok(const std::string_view& message) const
+	{
+		if constexpr (detail::checks_consumed<Checking>)
+		{
+			ASSERT(m_is_ok && !m_consumed.is_set(), message);
+		}
+		else if constexpr (detail::checks_side<Checking>)
+		{
+			ASSERT(m_is_ok, message);
+		}
+	}
+
+	void check_not_consumed(const char* message) const
+	{
+		if constexpr (detail::checks_consumed<Checking>)
+		{
+			ASSERT(!m_consumed.is_set(), message);
+		}
+	}
+
+	// Moves the stored value out of its heap allocation, which is freed on return.
+	// Pointer types are handed back as is, the caller becomes the owner, and empty types that are
+	// stored inline are moved out directly.
+	T take_value(void)
+	{
+		if constexpr (std::is_pointer<T>::value) return m_value.release();
+		else if constexpr (std::is_empty_v<T> && std::is_default_constructible_v<T>)
+			return std::move(m_value.get());
+		else
+		{
+			std::unique_ptr<typename OwningOk<T>::underlying_type> owned{ m_value.release() };
+			return std::move(*owned);
+		}
+	}
+
+	E take_error(void)
+	{
+		if constexpr (std::is_pointer<E>::value) return m_err.release();
+		else if constexpr (std::is_empty_v<E> && std::is_default_constructible_v<E>)
+			return std::move(m_err.get());
+		else
+		{
+			std::unique_ptr<typename OwningErr<E>::underlying_type> owned{ m_err.release() };
+			return std::move(*owned);
+		}
+	}
+
+	bool												 m_is_ok;
+	[[no_unique_address]] detail::ConsumedFlag<Checking> m_consumed;
+	[[no_unique_address]] OwningOk<T>					 m_value;
+	[[no_unique_address]] OwningErr<E>					 m_err;
+};
+
+namespace detail
+{
+	/// Side held by `OwningResult<void, E>` and `OwningResult<T, void>`, a consumed result still
+	/// remembers which side it held
+	enum class ResultState : std::uint8_t
+	{
+		ok,
+		err,
+		consumed_ok,
+		consumed_err
+	};
+
+	[[nodiscard]] constexpr bool is_consumed(ResultState state) noexcept
+	{
+		return state == ResultState::consumed_ok || state == ResultState::consumed_err;
+	}
+
+	/// Inline storage for the single value of `OwningResult<void, E>` and `OwningResult<T, void>`.
+	/// The owner tracks whether a value is alive and calls `construct`/`destroy` accordingly.
+	template<typename U, bool = std::is_empty_v<U> && std::is_default_constructible_v<U>>
+	class InlineSlot
+	{
+		public:
+
+		InlineSlot(void) noexcept {}
+		~InlineSlot(void) noexcept {}
+
+		void construct(U&& value) { std::construct_at(&m_value, std::move(value)); }
+		void destroy(void) noexcept { std::destroy_at(&m_value); }
+
+		U&		 get(void) noexcept { return m_value; }
+		const U& get(void) const noexcept { return m_value; }
+
+		private:
+
+		union
+		{
+			U m_value;
+		};
+	};
+
+	// Types without state need no storage: a default constructed instance is as good as any
+	template<typename U>
+	class InlineSlot<U, true>
+	{
+		public:
+
+		void construct(U&&) noexcept {}
+		void destroy(void) noexcept {}
+
+		U&		 get(void) noexcept { return m_value; }
+		const U& get(void) const noexcept { return m_value; }
+
+		private:
+
+		[[no_unique_address]] U m_value;
+	};
+} // namespace detail
+
+/// `OwningResult` for operations that only signal success or failure.
+/// The error is stored inline next to a one byte state, so constructing either side never
+/// allocates and the whole result is the size of `E` plus a tag.
+template<typename E, LikelihoodPolicy Likelihood, CheckingPolicy Checking>
+	requires(!std::is_void_v<E>)
+class OwningResult<void, E, Likelihood, Checking>
+{
+	public:
+
+	using value_type		= void;
+	using error_type		= E;
+	using likelihood_policy = Likelihood;
+	using checking_policy	= Checking;
+
+	OwningResult(OwningOk<void>) noexcept : m_state{ detail::ResultState::ok } {}
+
+	/// A bare error value is the Err side, there is nothing else it could be
+	OwningResult(E&& err) noexcept(std::is_nothrow_move_constructible_v<E>)
+		: m_state{ detail::ResultState::err }
+	{
+		m_err.construct(std::move(err));
+	}
+
+	/// Unboxes an `OwningErr<E>` so generic code can build every result the same way
+	OwningResult(OwningErr<E>&& err) : m_state{ detail::ResultState::err }
+	{
+		m_err.construct(std::move(err.get()));
+	}
+
+	OwningResult(OwningResult&& other) noexcept(std::is_nothrow_move_constructible_v<E>)
+		: m_state{ other.m_state }
+	{
+		if (m_state == detail::ResultState::err) m_err.construct(std::move(other.m_err.get()));
+	}
+
+	OwningResult& operator=(OwningResult&&) = delete;
+
+	~OwningResult(void)
+	{
+		if (m_state == detail::ResultState::err) m_err.destroy();
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_ok
+	[[nodiscard]] bool is_ok() const noexcept
+	{
+		return detail::predict_ok<Likelihood>(m_state == detail::ResultState::ok
+											  || m_state == detail::ResultState::consumed_ok);
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_err
+	/// Stays true after the error has been consumed
+	[[nodiscard]] bool is_err() const noexcept { return !is_ok(); }
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_err_and
+	[[nodiscard]] bool is_err_and(std::function<bool(E&)> func)
+	{
+		if (detail::predict_ok<Likelihood>(m_state != detail::ResultState::err)) return false;
+		else return func(m_err.get());
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.err
+	/// Consumes the error, if there is one
+	[[nodiscard]] std::optional<E> err()
+	{
+		if (detail::predict_ok<Likelihood>(m_state != detail::ResultState::err))
+			return std::nullopt;
+		std::optional<E> error(std::move(m_err.get()));
+		m_err.destroy();
+		m_state = detail::ResultState::consumed_err;
+		return error;
+	}
+
+	/// Returns a pointer to the error without consuming it, nullptr if there is none
+	[[nodiscard]] const E* peek_err() const noexcept
+	{
+		return m_state == detail::ResultState::err ? &m_err.get() : nullptr;
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map
+	/// Consumes `this`
+	template<typename U>
+	[[nodiscard]] OwningResult<U, E, Likelihood, Checking> map(std::function<U(void)>&& func)
+	{
+		using Mapped = OwningResult<U, E, Likelihood, Checking>;
+		check_not_consumed("map called on a consumed OwningResult");
+		if (!is_ok()) return Mapped(OwningErr<E>(*err()));
+		m_state = detail::ResultState::consumed_ok;
+		return Mapped(OwningOk<U>(func()));
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map_err
+	/// Consumes `this`
+	template<typename F>
+	[[nodiscard]] OwningResult<void, F, Likelihood, Checking> map_err(std::function<F(E&)>&& func)
+	{
+		using Mapped = OwningResult<void, F, Likelihood, Checking>;
+		check_not_consumed("map_err called on a consumed OwningResult");
+		if (is_ok())
+		{
+			m_state = detail::ResultState::consumed_ok;
+			return Mapped(OwningOk<void>());
+		}
+		F mapped = func(m_err.get());
+		m_err.destroy();
+		m_state = detail::ResultState::consumed_err;
+		return Mapped(std::move(mapped));
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.expect
+	/// Interrupts execution with `message` if `this` holds an error
+	void expect(const std::string_view& message) const
+	{
+		if constexpr (detail::checks_side<Checking>)
+		{
+			ASSERT(is_ok(), message);
+		}
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.unwrap
+	/// Interrupts execution if `this` holds an error
+	void unwrap() const { expect(""); }
+
+	private:
+
+	OwningResult() = delete;
+
+	// The state is kept and tested at every checking level, it decides whether the error is
+	// alive. Only the assertions depend on `Checking`.
+	void check_not_consumed(const char* message) const
+	{
+		if constexpr (detail::checks_consumed<Checking>)
+		{
+			ASSERT(!detail::is_consumed(m_state), message);
+		}
+	}
+
+	[[no_unique_address]] detail::InlineSlot<E> m_err;
+	detail::ResultState							m_state;
+};
+
+/// `OwningResult` for operations whose failure carries no information.
+/// The value is stored inline next to a one byte state, so constructing either side never
+/// allocates and the whole result is the size of `T` plus a tag.
+template<typename T, LikelihoodPolicy Likelihood, CheckingPolicy Checking>
+	requires(!std::is_void_v<T>)
+class OwningResult<T, void, Likelihood, Checking>
+{
+	public:
+
+	using value_type		= T;
+	using error_type		= void;
+	using likelihood_policy = Likelihood;
+	using checking_policy	= Checking;
+
+	/// A bare value is the Ok side, there is nothing else it could be
+	OwningResult(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
+		: m_state{ detail::ResultState::ok }
+	{
+		m_value.construct(std::move(value));
+	}
+
+	/// Unboxes an `OwningOk<T>` so generic code can build every result the same way
+	OwningResult(OwningOk<T>&& ok) : m_state{ detail::ResultState::ok }
+	{
+		m_value.construct(std::move(ok.get()));
+	}
+
+	OwningResult(OwningErr<void>) noexcept : m_state{ detail::ResultState::err } {}
+
+	OwningResult(OwningResult&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+		: m_state{ other.m_state }
+	{
+		if (m_state == detail::ResultState::ok) m_value.construct(std::move(other.m_value.get()));
+	}
+
+	OwningResult& operator=(OwningResult&&) = delete;
+
+	~OwningResult(void)
+	{
+		if (m_state == detail::ResultState::ok) m_value.destroy();
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_ok
+	/// Stays true after the value has been consumed
+	[[nodiscard]] bool is_ok() const noexcept
+	{
+		return detail::predict_ok<Likelihood>(m_state == detail::ResultState::ok
+											  || m_state == detail::ResultState::consumed_ok);
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_err
+	[[nodiscard]] bool is_err() const noexcept { return !is_ok(); }
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.is_ok_and
+	[[nodiscard]] bool is_ok_and(std::function<bool(T&)> func)
+	{
+		if (detail::predict_ok<Likelihood>(m_state == detail::ResultState::ok))
+			return func(m_value.get());
+		else return false;
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.ok
+	/// Consumes the value, if there is one
+	[[nodiscard]] std::optional<T> ok()
+	{
+		if (detail::predict_ok<Likelihood>(m_state == detail::ResultState::ok))
+			return std::optional<T>(take_value());
+		else return std::nullopt;
+	}
+
+	/// Returns a pointer to the value without consuming it, nullptr if there is none
+	[[nodiscard]] const T* peek_ok() const noexcept
+	{
+		return m_state == detail::ResultState::ok ? &m_value.get() : nullptr;
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map
+	/// Consumes `this`
+	template<typename U>
+	[[nodiscard]] OwningResult<U, void, Likelihood, Checking> map(std::function<U(T&)>&& func)
+	{
+		using Mapped = OwningResult<U, void, Likelihood, Checking>;
+		check_not_consumed("map called on a consumed OwningResult");
+		if (is_err())
+		{
+			m_state = detail::ResultState::consumed_err;
+			return Mapped(OwningErr<void>());
+		}
+		U mapped = func(m_value.get());
+		m_value.destroy();
+		m_state = detail::ResultState::consumed_ok;
+		return Mapped(std::move(mapped));
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.map_or
+	template<typename U>
+	[[nodiscard]] U map_or(U default_value, std::function<U(T&)>&& func)
+	{
+		if (detail::predict_ok<Likelihood>(m_state == detail::ResultState::ok))
+			return func(m_value.get());
+		else return default_value;
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.expect
+	/// Consumes `this`, interrupts execution with `message` if there is no value
+	T expect(const std::string_view& message)
+	{
+		check_ok(message);
+		return take_value();
+	}
+
+	/// https://doc.rust-lang.org/std/result/enum.Result.html#method.unwrap
+	/// Consumes `this`, interrupts execution if there is no value
+	T unwrap()
+	{
+		check_ok("");
+		return take_value();
 	}
 
 	private:
 
 	OwningResult() = delete;
 
-	bool		 m_is_ok;
-	bool		 m_is_consumed;
-	OwningOk<T>	 m_value;
-	OwningErr<E> m_err;
+	void check_ok(const std::string_view& message) const
+	{
+		if constexpr (detail::checks_consumed<Checking>)
+		{
+			ASSERT(m_state == detail::ResultState::ok, message);
+		}
+		else if constexpr (detail::checks_side<Checking>)
+		{
+			ASSERT(is_ok(), message);
+		}
+	}
+
+	void check_not_consumed(const char* message) const
+	{
+		if constexpr (detail::checks_consumed<Checking>)
+		{
+			ASSERT(!detail::is_consumed(m_state), message);
+		}
+	}
+
+	T take_value(void)
+	{
+		T value(std::move(m_value.get()));
+		m_value.destroy();
+		m_state = detail::ResultState::consumed_ok;
+		return value;
+	}
+
+	[[no_unique_address]] detail::InlineSlot<T> m_value;
+	detail::ResultState							m_state;
 };
 
 /// NonowningResult employes the NonowningOk and NonowningErr data structures.
@@ -272,4 +732,68 @@ class NonowningResult
 	NonowningErr<E> m_err;
 };
 
+/// BorrowedResult refers to an Ok value or an error that lives somewhere else, e.g. in a buffer
+/// a producer reuses from one record to the next. It is two pointers, never allocates and never
+/// consumes: the referenced object must outlive the BorrowedResult, and whoever owns it decides
+/// whether moving out of `unwrap()` is allowed.
+template<typename T, typename E>
+class BorrowedResult
+{
+	public:
+
+	using value_type = T;
+	using error_type = E;
+
+	[[nodiscard]] static BorrowedResult borrow_ok(T& value) noexcept
+	{
+		return BorrowedResult(&value, nullptr);
+	}
+
+	[[nodiscard]] static BorrowedResult borrow_err(E& error) noexcept
+	{
+		return BorrowedResult(nullptr, &error);
+	}
+
+	[[nodiscard]] bool is_ok() const noexcept { return m_value != nullptr; }
+
+	[[nodiscard]] bool is_err() const noexcept { return m_value == nullptr; }
+
+	/// Returns a pointer to the referenced Ok value, nullptr if `this` refers to an error
+	[[nodiscard]] T* peek_ok() const noexcept { return m_value; }
+
+	/// Returns a pointer to the referenced error, nullptr if `this` refers to an Ok value
+	[[nodiscard]] E* peek_err() const noexcept { return m_err; }
+
+	/// Returns the referenced Ok value.
+	/// Function interrupts execution if `this` refers to an error.
+	T& expect(const std::string_view& message) const
+	{
+		ASSERT(m_value != nullptr, message);
+		return *m_value;
+	}
+
+	/// Returns the referenced Ok value.
+	/// Function interrupts execution if `this` refers to an error.
+	T& unwrap() const
+	{
+		ASSERT(m_value != nullptr, "");
+		return *m_value;
+	}
+
+	/// Returns the referenced error.
+	/// Function interrupts execution if `this` refers to an Ok value.
+	E& unwrap_err() const
+	{
+		ASSERT(m_err != nullptr, "");
+		return *m_err;
+	}
+
+	private:
+
+	BorrowedResult(T* value, E* error) noexcept : m_value{ value }, m_err{ error } {}
+
+	T* m_value;
+	E* m_err;
+};
+
 #endif
@@ -0,0 +1,404 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: ResultChannel.hpp
+// Description: Bounded lock-free channels moving `OwningResult<T, E>` between threads
+// =================================
+//
+
+#ifndef OL_RESULT_CHANNEL_HPP
+#define OL_RESULT_CHANNEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Assertions.hpp"
+#include "Result.hpp"
+
+/// What a channel does when an `OwningErr<E>` is pushed into it
+enum class ChannelPolicy {
+	/// Errors are passed along like any other value
+	KeepOpen,
+	/// The channel is closed right after the first error: later pushes fail and consumers drain
+	/// what is left (the error included) before `pop` reports the end of the stream
+	CloseOnErr
+};
+
+// Fixed instead of std::hardware_destructive_interference_size, which gcc warns is not ABI stable
+inline constexpr std::size_t result_channel_cache_line = 64;
+
+/// Blocking operations and closing shared by both channels.
+/// `Channel` provides `try_push(OwningResult<T, E>&&)` and `try_pop()`.
+template<typename Channel, typename T, typename E, ChannelPolicy Policy>
+class ResultChannelBase
+{
+	public:
+
+	using value_type = OwningResult<T, E>;
+
+	/// Pushes `result`, spinning while the channel is full.
+	/// Returns false, leaving `result` untouched, if the channel is closed.
+	bool push(value_type&& result)
+	{
+		for (std::size_t spins = 0; !is_closed(); ++spins)
+		{
+			if (derived().try_push(std::move(result))) return true;
+			backoff(spins);
+		}
+		return false;
+	}
+
+	/// Pops the oldest result, spinning while the channel is empty.
+	/// Returns std::nullopt once the channel is closed and fully drained.
+	std::optional<value_type> pop()
+	{
+		for (std::size_t spins = 0;; ++spins)
+		{
+			if (auto result = derived().try_pop()) return result;
+			// A claimed cell may still be waiting for its producer to publish it
+			if (is_closed() && derived().drained()) return std::nullopt;
+			backoff(spins);
+		}
+	}
+
+	/// Pushes as many results from the front of `results` as currently fit without blocking and
+	/// returns how many were moved into the channel
+	std::size_t push_n(std::span<value_type> results)
+	{
+		std::size_t pushed = 0;
+		while (pushed < results.size() && derived().try_push(std::move(results[pushed])))
+			++pushed;
+		return pushed;
+	}
+
+	/// Appends up to `max_count` results to `out` without blocking and returns how many were
+	/// popped
+	std::size_t pop_n(std::vector<value_type>& out, std::size_t max_count)
+	{
+		std::size_t popped = 0;
+		while (popped < max_count)
+		{
+			auto result = derived().try_pop();
+			if (!result) break;
+			out.push_back(std::move(*result));
+			++popped;
+		}
+		return popped;
+	}
+
+	/// Stops accepting new results, consumers can still drain what was pushed before
+	void close() noexcept
+	{
+		derived().seal();
+		m_closed.store(true, std::memory_order_release);
+	}
+
+	[[nodiscard]] bool is_closed() const noexcept
+	{
+		return m_closed.load(std::memory_order_acquire);
+	}
+
+	protected:
+
+	// True if the channel has to be closed once `result` is published
+	static bool closes_channel(const value_type& result) noexcept
+	{
+		if constexpr (Policy == ChannelPolicy::CloseOnErr) return result.is_err();
+		else return false;
+	}
+
+	static void backoff(std::size_t spins) noexcept
+	{
+		if (spins > 64) std::this_thread::yield();
+	}
+
+	private:
+
+	Channel& derived() noexcept { return static_cast<Channel&>(*this); }
+
+	std::atomic<bool> m_closed{ false };
+};
+
+/// Raw storage for one `OwningResult<T, E>`, which is neither default constructible nor
+/// assignable
+template<typename T, typename E>
+class ResultSlot
+{
+	public:
+
+	void construct(OwningResult<T, E>&& result) noexcept
+	{
+		::new (static_cast<void*>(m_storage)) OwningResult<T, E>(std::move(result));
+	}
+
+	OwningResult<T, E> take() noexcept
+	{
+		auto*			   stored = std::launder(reinterpret_cast<OwningResult<T, E>*>(m_storage));
+		OwningResult<T, E> result(std::move(*stored));
+		stored->~OwningResult<T, E>();
+		return result;
+	}
+
+	void destroy() noexcept
+	{
+		std::launder(reinterpret_cast<OwningResult<T, E>*>(m_storage))->~OwningResult<T, E>();
+	}
+
+	private:
+
+	alignas(OwningResult<T, E>) std::byte m_storage[sizeof(OwningResult<T, E>)];
+};
+
+/// Single producer, single consumer ring buffer.
+/// Exactly one thread may push and exactly one (possibly different) thread may pop.
+/// `close` has to be called by the producer, or after it stopped pushing.
+/// The capacity is rounded up to a power of two.
+template<typename T, typename E, ChannelPolicy Policy = ChannelPolicy::KeepOpen>
+class SpscResultChannel : public ResultChannelBase<SpscResultChannel<T, E, Policy>, T, E, Policy>
+{
+	friend ResultChannelBase<SpscResultChannel, T, E, Policy>;
+
+	public:
+
+	using value_type = OwningResult<T, E>;
+
+	explicit SpscResultChannel(std::size_t capacity)
+		: m_mask{ std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1 },
+		  m_slots{ std::make_unique<ResultSlot<T, E>[]>(m_mask + 1) }
+	{
+	}
+
+	SpscResultChannel(const SpscResultChannel&)			   = delete;
+	SpscResultChannel& operator=(const SpscResultChannel&) = delete;
+
+	~SpscResultChannel()
+	{
+		for (std::size_t i = m_head.load(); i != m_tail.load(); ++i)
+			m_slots[i & m_mask].destroy();
+	}
+
+	/// Moves `result` into the channel unless it is full or closed
+	bool try_push(value_type&& result)
+	{
+		if (this->is_closed()) return false;
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cached_head > m_mask)
+		{
+			m_cached_head = m_head.load(std::memory_order_acquire);
+			if (tail - m_cached_head > m_mask) return false;
+		}
+		bool closing = this->closes_channel(result);
+		m_slots[tail & m_mask].construct(std::move(result));
+		m_tail.store(tail + 1, std::memory_order_release);
+		if (closing) this->close();
+		return true;
+	}
+
+	/// Pops the oldest result, std::nullopt if the channel is empty
+	std::optional<value_type> try_pop()
+	{
+		std::size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_cached_tail)
+		{
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+			if (head == m_cached_tail) return std::nullopt;
+		}
+		std::optional<value_type> result(m_slots[head & m_mask].take());
+		m_head.store(head + 1, std::memory_order_release);
+		return result;
+	}
+
+	/// Batch push: the free space is looked up and published once for the whole batch
+	std::size_t push_n(std::span<value_type> results)
+	{
+		if (this->is_closed()) return 0;
+		std::size_t tail  = m_tail.load(std::memory_order_relaxed);
+		m_cached_head	  = m_head.load(std::memory_order_acquire);
+		std::size_t count = std::min(m_mask + 1 - (tail - m_cached_head), results.size());
+
+		std::size_t pushed	= 0;
+		bool		closing = false;
+		while (pushed < count && !closing)
+		{
+			closing = this->closes_channel(results[pushed]);
+			m_slots[(tail + pushed) & m_mask].construct(std::move(results[pushed]));
+			++pushed;
+		}
+		m_tail.store(tail + pushed, std::memory_order_release);
+		if (closing) this->close();
+		return pushed;
+	}
+
+	/// Batch pop: the available elements are looked up and released once for the whole batch
+	std::size_t pop_n(std::vector<value_type>& out, std::size_t max_count)
+	{
+		std::size_t head  = m_head.load(std::memory_order_relaxed);
+		m_cached_tail	  = m_tail.load(std::memory_order_acquire);
+		std::size_t count = std::min(m_cached_tail - head, max_count);
+		for (std::size_t i = 0; i < count; ++i)
+			out.push_back(m_slots[(head + i) & m_mask].take());
+		m_head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	[[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+
+	private:
+
+	// The producer closes the channel itself, so there is no push left to shut out
+	void seal() noexcept {}
+
+	bool drained() const noexcept
+	{
+		return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+	}
+
+	const std::size_t					m_mask;
+	std::unique_ptr<ResultSlot<T, E>[]> m_slots;
+
+	// Consumer side
+	alignas(result_channel_cache_line) std::atomic<std::size_t> m_head{ 0 };
+	std::size_t m_cached_tail{ 0 };
+
+	// Producer side
+	alignas(result_channel_cache_line) std::atomic<std::size_t> m_tail{ 0 };
+	std::size_t m_cached_head{ 0 };
+};
+
+/// Multi producer, multi consumer bounded queue after Dmitry Vyukov's design: every cell carries
+/// a sequence number telling producers and consumers whose turn it is, so the only contended
+/// operation is one compare-and-swap on the enqueue or dequeue position.
+/// The capacity is rounded up to a power of two.
+/// Closing sets a sealed bit in the enqueue position, so no producer can claim a cell once the
+/// channel is closed and consumers know exactly how many cells are left to drain.
+/// With `ChannelPolicy::CloseOnErr`, results pushed concurrently with the first error may still
+/// be delivered after it.
+template<typename T, typename E, ChannelPolicy Policy = ChannelPolicy::KeepOpen>
+class MpmcResultChannel : public ResultChannelBase<MpmcResultChannel<T, E, Policy>, T, E, Policy>
+{
+	friend ResultChannelBase<MpmcResultChannel, T, E, Policy>;
+
+	public:
+
+	using value_type = OwningResult<T, E>;
+
+	explicit MpmcResultChannel(std::size_t capacity)
+		: m_mask{ std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1 },
+		  m_cells{ std::make_unique<Cell[]>(m_mask + 1) }
+	{
+		for (std::size_t i = 0; i <= m_mask; ++i)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MpmcResultChannel(const MpmcResultChannel&)			   = delete;
+	MpmcResultChannel& operator=(const MpmcResultChannel&) = delete;
+
+	~MpmcResultChannel()
+	{
+		while (try_pop())
+		{
+		}
+	}
+
+	/// Moves `result` into the channel unless it is full or closed
+	bool try_push(value_type&& result)
+	{
+		std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+		Cell*		cell;
+		while (true)
+		{
+			if (position & sealed) return false;
+			cell					  = &m_cells[position & m_mask];
+			std::size_t	   sequence	  = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence)
+									  - static_cast<std::ptrdiff_t>(position);
+			if (difference == 0)
+			{
+				if (m_enqueue.compare_exchange_weak(position, position + 1,
+													std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0) return false;
+			else position = m_enqueue.load(std::memory_order_relaxed);
+		}
+		bool closing = this->closes_channel(result);
+		cell->slot.construct(std::move(result));
+		cell->sequence.store(position + 1, std::memory_order_release);
+		if (closing) this->close();
+		return true;
+	}
+
+	/// Pops the oldest result, std::nullopt if the channel is empty
+	std::optional<value_type> try_pop()
+	{
+		std::size_t position = m_dequeue.load(std::memory_order_relaxed);
+		Cell*		cell;
+		while (true)
+		{
+			cell					  = &m_cells[position & m_mask];
+			std::size_t	   sequence	  = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence)
+									  - static_cast<std::ptrdiff_t>(position + 1);
+			if (difference == 0)
+			{
+				if (m_dequeue.compare_exchange_weak(position, position + 1,
+													std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0) return std::nullopt;
+			else position = m_dequeue.load(std::memory_order_relaxed);
+		}
+		std::optional<value_type> result(cell->slot.take());
+		cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+		return result;
+	}
+
+	[[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+
+	private:
+
+	static constexpr std::size_t sealed = ~(~std::size_t{ 0 } >> 1);
+
+	void seal() noexcept { m_enqueue.fetch_or(sealed, std::memory_order_acq_rel); }
+
+	// Only meaningful once sealed: every claimed cell has been claimed by a consumer as well
+	bool drained() const noexcept
+	{
+		return m_dequeue.load(std::memory_order_acquire)
+			>= (m_enqueue.load(std::memory_order_acquire) & ~sealed);
+	}
+
+	struct alignas(result_channel_cache_line) Cell {
+		std::atomic<std::size_t> sequence;
+		ResultSlot<T, E>		 slot;
+	};
+
+	const std::size_t		m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+	alignas(result_channel_cache_line) std::atomic<std::size_t> m_enqueue{ 0 };
+	alignas(result_channel_cache_line) std::atomic<std::size_t> m_dequeue{ 0 };
+};
+
+#endif
@@ -0,0 +1,292 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: ResultStream.hpp
+// Description: A coroutine generator yielding one result per record, with a policy deciding
+//              what happens to the records that fail
+// =================================
+//
+
+#ifndef OL_RESULT_STREAM_HPP
+#define OL_RESULT_STREAM_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "Assertions.hpp"
+#include "MultiErr.hpp"
+#include "Result.hpp"
+
+/// Every error is handed to the consumer, and the stream ends after it
+struct StopOnError {
+};
+
+/// Errors are counted and never reach the consumer
+struct SkipErrors {
+};
+
+/// Errors never reach the consumer, the first `N` are kept in a `MultiErr<E, N>` and the rest
+/// are counted
+template<std::size_t N>
+struct CollectErrors {
+	static constexpr std::size_t capacity = N;
+};
+
+namespace detail
+{
+	template<typename Policy>
+	struct is_collect_errors : std::false_type {
+	};
+
+	template<std::size_t N>
+	struct is_collect_errors<CollectErrors<N>> : std::true_type {
+	};
+
+	template<typename E, typename Policy>
+	struct StreamErrorSink {
+		std::size_t skipped{ 0 };
+	};
+
+	template<typename E, std::size_t N>
+	struct StreamErrorSink<E, CollectErrors<N>> {
+		MultiErr<E, N> errors;
+	};
+} // namespace detail
+
+template<typename Policy>
+concept StreamErrorPolicy = std::is_same_v<Policy, StopOnError>
+						 || std::is_same_v<Policy, SkipErrors>
+						 || detail::is_collect_errors<Policy>::value;
+
+/// A lazily evaluated sequence of per-record results, written as a coroutine:
+///
+///     ResultStream<Record, ParseError> parse(std::istream& in)
+///     {
+///         Record record;
+///         for (std::string line; std::getline(in, line);)
+///             if (parse_into(line, record)) co_yield record;
+///             else co_yield OwningErr<ParseError>(...);
+///     }
+///
+/// The coroutine only runs when the consumer asks for the next record, so a slow consumer holds
+/// back the producer, and nothing is read ahead or materialized.
+/// The stream is a `std::ranges::input_range` of `BorrowedResult<T, E>`: a yielded lvalue is
+/// referred to, not copied, until the consumer advances. Producers that yield the same buffer
+/// for every record therefore iterate without allocating once the buffer has grown to size; the
+/// consumer may move out of it, the producer must then reset it before the next record.
+/// Errors can be yielded as `OwningErr<E>` (one allocation each) or as a borrowed error.
+/// An exception escaping the coroutine is rethrown from `begin()` or `++`.
+template<typename T, typename E, StreamErrorPolicy Policy = StopOnError>
+class ResultStream
+{
+	public:
+
+	using record_type = BorrowedResult<T, E>;
+
+	class promise_type
+	{
+		public:
+
+		ResultStream get_return_object(void) noexcept
+		{
+			return ResultStream(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend(void) const noexcept { return {}; }
+		std::suspend_always final_suspend(void) const noexcept { return {}; }
+
+		// Temporaries live until the end of the full expression containing the co_yield, which
+		// is after the coroutine has been resumed again, so borrowing them is safe
+		std::suspend_always yield_value(T& value) noexcept { return borrow(&value, nullptr); }
+
+		std::suspend_always yield_value(T&& value) noexcept { return borrow(&value, nullptr); }
+
+		std::suspend_always yield_value(OwningErr<E>&& error) noexcept
+		{
+			return borrow(nullptr, &error.get());
+		}
+
+		std::suspend_always yield_value(record_type record) noexcept
+		{
+			return borrow(record.peek_ok(), record.peek_err());
+		}
+
+		void return_void(void) const noexcept {}
+
+		void unhandled_exception(void) noexcept { m_exception = std::current_exception(); }
+
+		// Co_await has no meaning in a generator
+		void await_transform() = delete;
+
+		private:
+
+		friend ResultStream;
+
+		std::suspend_always borrow(T* value, E* error) noexcept
+		{
+			m_value = value;
+			m_error = error;
+			return {};
+		}
+
+		T*				   m_value{ nullptr };
+		E*				   m_error{ nullptr };
+		std::exception_ptr m_exception;
+	};
+
+	class iterator
+	{
+		public:
+
+		using iterator_concept = std::input_iterator_tag;
+		using value_type	   = record_type;
+		using difference_type  = std::ptrdiff_t;
+
+		iterator(void) = default;
+
+		record_type operator*(void) const noexcept { return m_stream->current(); }
+
+		iterator& operator++(void)
+		{
+			m_stream->advance();
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+		{
+			return it.done();
+		}
+
+		private:
+
+		friend ResultStream;
+
+		[[nodiscard]] bool done(void) const noexcept { return m_stream->finished(); }
+
+		explicit iterator(ResultStream* stream) noexcept : m_stream{ stream } {}
+
+		ResultStream* m_stream{ nullptr };
+	};
+
+	ResultStream(ResultStream&& other) noexcept
+		: m_handle{ std::exchange(other.m_handle, nullptr) },
+		  m_sink{ std::move(other.m_sink) },
+		  m_started{ other.m_started },
+		  m_stopped{ other.m_stopped }
+	{
+	}
+
+	ResultStream& operator=(ResultStream&&) = delete;
+	ResultStream(const ResultStream&)		= delete;
+	ResultStream& operator=(const ResultStream&) = delete;
+
+	~ResultStream(void)
+	{
+		if (m_handle) m_handle.destroy();
+	}
+
+	/// Runs the coroutine up to its first record. Can only be called once, the stream is a
+	/// single pass range.
+	iterator begin(void)
+	{
+		ASSERT(!m_started, "ResultStream can only be iterated once");
+		advance();
+		m_started = true;
+		return iterator(this);
+	}
+
+	std::default_sentinel_t end(void) const noexcept { return {}; }
+
+	/// Number of errors dropped so far, only with `SkipErrors`
+	[[nodiscard]] std::size_t skipped(void) const noexcept
+		requires std::is_same_v<Policy, SkipErrors>
+	{
+		return m_sink.skipped;
+	}
+
+	/// Errors collected so far, only with `CollectErrors<N>`
+	[[nodiscard]] const auto& errors(void) const noexcept
+		requires detail::is_collect_errors<Policy>::value
+	{
+		return m_sink.errors;
+	}
+
+	/// Moves out the errors collected so far, only with `CollectErrors<N>`
+	[[nodiscard]] auto take_errors(void) noexcept(std::is_nothrow_move_constructible_v<E>)
+		requires detail::is_collect_errors<Policy>::value
+	{
+		return std::move(m_sink.errors);
+	}
+
+	private:
+
+	explicit ResultStream(std::coroutine_handle<promise_type> handle) noexcept
+		: m_handle{ handle }
+	{
+	}
+
+	[[nodiscard]] record_type current(void) const noexcept
+	{
+		const promise_type& promise = m_handle.promise();
+		if (promise.m_value != nullptr) return record_type::borrow_ok(*promise.m_value);
+		return record_type::borrow_err(*promise.m_error);
+	}
+
+	[[nodiscard]] bool finished(void) const noexcept { return m_stopped || m_handle.done(); }
+
+	// Resumes the producer until it yields a record the policy lets through, or returns
+	void advance(void)
+	{
+		if (finished()) return;
+		promise_type& promise = m_handle.promise();
+		if constexpr (std::is_same_v<Policy, StopOnError>)
+		{
+			// The error was handed out by the previous call, nothing follows it
+			if (m_started && promise.m_error != nullptr)
+			{
+				m_stopped = true;
+				return;
+			}
+		}
+
+		while (true)
+		{
+			m_handle.resume();
+			if (promise.m_exception) [[unlikely]]
+				std::rethrow_exception(std::exchange(promise.m_exception, nullptr));
+			if (m_handle.done() || promise.m_value != nullptr) [[likely]]
+				return;
+
+			if constexpr (std::is_same_v<Policy, StopOnError>) return;
+			else if constexpr (std::is_same_v<Policy, SkipErrors>) ++m_sink.skipped;
+			else m_sink.errors.push(std::move(*promise.m_error));
+		}
+	}
+
+	std::coroutine_handle<promise_type>						 m_handle;
+	[[no_unique_address]] detail::StreamErrorSink<E, Policy> m_sink;
+	bool													 m_started{ false };
+	bool													 m_stopped{ false };
+};
+
+#endif
@@ -0,0 +1,492 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: Serialize.hpp
+// Description: Versioned binary encoding of `OwningResult<T, E>` and of sequences of results.
+//              Trivially copyable payloads can be read in place from a mapped buffer.
+// =================================
+//
+
+#ifndef OL_SERIALIZE_HPP
+#define OL_SERIALIZE_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Assertions.hpp"
+#include "Result.hpp"
+
+// Layout of an encoded result (all integers in native byte order):
+//
+//     ResultRecordHeader | padding up to payload alignment | payload bytes
+//
+// The payload is the `T` of an Ok or the `E` of an Err as written by `ResultCodec`.
+// A batch of results is laid out as
+//
+//     ResultBatchHeader | uint64_t offsets[count] | record 0 | padding | record 1 | ...
+//
+// where every record starts at an offset, relative to the start of the batch, that is a
+// multiple of the largest alignment needed by `T`, `E` and the record header. As long as the
+// buffer itself is suitably aligned (heap allocations and mmap'd files are) every payload is
+// correctly aligned for in place access.
+
+/// Reasons for which a buffer can be rejected while decoding
+enum class SerializationError {
+	BadMagic,
+	UnsupportedVersion,
+	Truncated,
+	Misaligned,
+	SizeMismatch
+};
+
+inline constexpr std::uint32_t result_record_magic	 = 0x53524C4F;	  // "OLRS"
+inline constexpr std::uint32_t result_batch_magic	 = 0x42524C4F;	  // "OLRB"
+inline constexpr std::uint16_t result_format_version = 1;
+
+struct ResultRecordHeader {
+	std::uint32_t magic;
+	std::uint16_t version;
+	std::uint8_t  is_ok;
+	std::uint8_t  reserved;
+	std::uint32_t payload_offset;
+	std::uint32_t payload_alignment;
+	std::uint64_t payload_size;
+};
+
+struct ResultBatchHeader {
+	std::uint32_t magic;
+	std::uint16_t version;
+	std::uint16_t reserved;
+	std::uint64_t count;
+	std::uint64_t total_size;
+};
+
+static_assert(sizeof(ResultRecordHeader) == 24);
+static_assert(sizeof(ResultBatchHeader) == 24);
+static_assert(std::is_trivially_copyable_v<ResultRecordHeader>);
+static_assert(std::is_trivially_copyable_v<ResultBatchHeader>);
+
+/// Customization point describing how a payload type is written to and read from bytes.
+/// Specializations provide:
+///   - `in_place`:  true if the encoded bytes are the object representation of `U`, in which
+///                  case readers can access the payload without decoding
+///   - `alignment`: alignment the payload needs in the buffer
+///   - `size(value)`, `encode(value, out)` and `decode(bytes)`
+/// Trivially copyable types and `std::string` are supported out of the box.
+template<typename U>
+struct ResultCodec;
+
+template<typename U>
+	requires std::is_trivially_copyable_v<U>
+struct ResultCodec<U> {
+	static constexpr bool		 in_place  = true;
+	static constexpr std::size_t alignment = alignof(U);
+
+	static std::size_t size(const U&) noexcept { return sizeof(U); }
+
+	static void encode(const U& value, std::byte* out) noexcept
+	{
+		std::memcpy(out, &value, sizeof(U));
+	}
+
+	static U decode(std::span<const std::byte> bytes) noexcept
+	{
+		U value;
+		std::memcpy(&value, bytes.data(), sizeof(U));
+		return value;
+	}
+};
+
+template<>
+struct ResultCodec<std::string> {
+	static constexpr bool		 in_place  = false;
+	static constexpr std::size_t alignment = 1;
+
+	static std::size_t size(const std::string& value) noexcept { return value.size(); }
+
+	static void encode(const std::string& value, std::byte* out) noexcept
+	{
+		std::memcpy(out, value.data(), value.size());
+	}
+
+	static std::string decode(std::span<const std::byte> bytes)
+	{
+		return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+};
+
+template<typename U>
+concept ResultEncodable =
+	requires(const U& value, std::byte* out, std::span<const std::byte> bytes) {
+		{ ResultCodec<U>::in_place } -> std::convertible_to<bool>;
+		{ ResultCodec<U>::alignment } -> std::convertible_to<std::size_t>;
+		{ ResultCodec<U>::size(value) } -> std::convertible_to<std::size_t>;
+		ResultCodec<U>::encode(value, out);
+		{ ResultCodec<U>::decode(bytes) } -> std::same_as<U>;
+	};
+
+namespace detail
+{
+	constexpr std::size_t align_up(std::size_t value, std::size_t alignment) noexcept
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	inline bool is_aligned(const void* ptr, std::size_t alignment) noexcept
+	{
+		return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+	}
+
+	template<typename U>
+	constexpr std::size_t payload_offset() noexcept
+	{
+		return align_up(sizeof(ResultRecordHeader), ResultCodec<U>::alignment);
+	}
+}    // namespace detail
+
+/// Alignment every encoded record of an `OwningResult<T, E>` starts at
+template<ResultEncodable T, ResultEncodable E>
+inline constexpr std::size_t result_record_alignment =
+	std::max({ alignof(ResultRecordHeader), ResultCodec<T>::alignment, ResultCodec<E>::alignment });
+
+/// Number of bytes `encode_result` writes for `result`
+template<ResultEncodable T, ResultEncodable E>
+[[nodiscard]] std::size_t encoded_size(const OwningResult<T, E>& result)
+{
+	if (const T* value = result.peek_ok())
+		return detail::payload_offset<T>() + ResultCodec<T>::size(*value);
+	const E* error = result.peek_err();
+	ASSERT(error != nullptr, "cannot encode a consumed OwningResult");
+	return detail::payload_offset<E>() + ResultCodec<E>::size(*error);
+}
+
+/// Writes `result` to the start of `out` without consuming it and returns the number of bytes
+/// written. `out` must be aligned to `result_record_alignment<T, E>` and hold at least
+/// `encoded_size(result)` bytes.
+template<ResultEncodable T, ResultEncodable E>
+std::size_t encode_result(const OwningResult<T, E>& result, std::span<std::byte> out)
+{
+	std::size_t size = encoded_size(result);
+	ASSERT(out.size() >= size, "output buffer too small to encode OwningResult");
+	ASSERT(detail::is_aligned(out.data(), result_record_alignment<T, E>),
+		   "output buffer is not aligned for OwningResult");
+
+	ResultRecordHeader header{};
+	header.magic   = result_record_magic;
+	header.version = result_format_version;
+	header.is_ok   = result.is_ok() ? 1 : 0;
+	if (const T* value = result.peek_ok())
+	{
+		header.payload_offset	 = static_cast<std::uint32_t>(detail::payload_offset<T>());
+		header.payload_alignment = static_cast<std::uint32_t>(ResultCodec<T>::alignment);
+		header.payload_size		 = ResultCodec<T>::size(*value);
+		ResultCodec<T>::encode(*value, out.data() + header.payload_offset);
+	}
+	else
+	{
+		const E* error			 = result.peek_err();
+		header.payload_offset	 = static_cast<std::uint32_t>(detail::payload_offset<E>());
+		header.payload_alignment = static_cast<std::uint32_t>(ResultCodec<E>::alignment);
+		header.payload_size		 = ResultCodec<E>::size(*error);
+		ResultCodec<E>::encode(*error, out.data() + header.payload_offset);
+	}
+	std::memcpy(out.data(), &header, sizeof(header));
+	return size;
+}
+
+/// Convenience overload allocating a buffer that fits exactly one record
+template<ResultEncodable T, ResultEncodable E>
+[[nodiscard]] std::vector<std::byte> encode_result(const OwningResult<T, E>& result)
+{
+	static_assert(result_record_alignment<T, E> <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+				  "over-aligned payloads need a caller provided buffer");
+	std::vector<std::byte> bytes(encoded_size(result));
+	encode_result(result, std::span<std::byte>(bytes));
+	return bytes;
+}
+
+template<ResultEncodable T, ResultEncodable E>
+class ResultBatchView;
+
+/// Borrowed, validated view of one encoded `OwningResult<T, E>`.
+/// The view does not own the bytes, they have to outlive it.
+template<ResultEncodable T, ResultEncodable E>
+class ResultView
+{
+	friend ResultBatchView<T, E>;
+
+	public:
+
+	/// Checks the header and bounds of the record starting at `bytes.data()`
+	[[nodiscard]] static OwningResult<ResultView, SerializationError>
+	from_bytes(std::span<const std::byte> bytes)
+	{
+		SerializationError error;
+		if (!validate(bytes, error)) return OwningErr<SerializationError>(std::move(error));
+		return OwningOk<ResultView>(ResultView(bytes.data()));
+	}
+
+	[[nodiscard]] bool is_ok() const noexcept { return header().is_ok != 0; }
+
+	[[nodiscard]] bool is_err() const noexcept { return header().is_ok == 0; }
+
+	/// Encoded bytes of the Ok or Err payload
+	[[nodiscard]] std::span<const std::byte> payload() const noexcept
+	{
+		ResultRecordHeader h = header();
+		return std::span<const std::byte>(m_record + h.payload_offset,
+										  static_cast<std::size_t>(h.payload_size));
+	}
+
+	/// Reference to the Ok payload inside the buffer, no copy is made
+	[[nodiscard]] const T& ok_ref() const noexcept
+		requires(ResultCodec<T>::in_place)
+	{
+		ASSERT(is_ok(), "ResultView::ok_ref called on an Err record");
+		return *std::launder(reinterpret_cast<const T*>(payload().data()));
+	}
+
+	/// Reference to the Err payload inside the buffer, no copy is made
+	[[nodiscard]] const E& err_ref() const noexcept
+		requires(ResultCodec<E>::in_place)
+	{
+		ASSERT(is_err(), "ResultView::err_ref called on an Ok record");
+		return *std::launder(reinterpret_cast<const E*>(payload().data()));
+	}
+
+	/// Decodes a copy of the Ok payload
+	[[nodiscard]] T decode_ok() const
+	{
+		ASSERT(is_ok(), "ResultView::decode_ok called on an Err record");
+		return ResultCodec<T>::decode(payload());
+	}
+
+	/// Decodes a copy of the Err payload
+	[[nodiscard]] E decode_err() const
+	{
+		ASSERT(is_err(), "ResultView::decode_err called on an Ok record");
+		return ResultCodec<E>::decode(payload());
+	}
+
+	/// Decodes the record back into an `OwningResult<T, E>`
+	[[nodiscard]] OwningResult<T, E> to_owned() const
+	{
+		if (is_ok()) return OwningOk<T>(decode_ok());
+		return OwningErr<E>(decode_err());
+	}
+
+	/// Checks the header of the record at the start of `bytes`, `error` is set on failure
+	static bool validate(std::span<const std::byte> bytes, SerializationError& error) noexcept
+	{
+		if (bytes.size() < sizeof(ResultRecordHeader))
+		{
+			error = SerializationError::Truncated;
+			return false;
+		}
+		if (!detail::is_aligned(bytes.data(), alignof(ResultRecordHeader)))
+		{
+			error = SerializationError::Misaligned;
+			return false;
+		}
+
+		ResultRecordHeader h;
+		std::memcpy(&h, bytes.data(), sizeof(h));
+		if (h.magic != result_record_magic)
+		{
+			error = SerializationError::BadMagic;
+			return false;
+		}
+		if (h.version != result_format_version)
+		{
+			error = SerializationError::UnsupportedVersion;
+			return false;
+		}
+
+		bool		is_ok		  = h.is_ok != 0;
+		std::size_t offset		  = is_ok ? detail::payload_offset<T>() : detail::payload_offset<E>();
+		std::size_t alignment	  = is_ok ? ResultCodec<T>::alignment : ResultCodec<E>::alignment;
+		bool		in_place	  = is_ok ? ResultCodec<T>::in_place : ResultCodec<E>::in_place;
+		std::size_t in_place_size = is_ok ? sizeof(T) : sizeof(E);
+		if (h.payload_offset != offset || h.payload_alignment != alignment
+			|| (in_place && h.payload_size != in_place_size))
+		{
+			error = SerializationError::SizeMismatch;
+			return false;
+		}
+		// The offset is checked on its own first, the difference would wrap around otherwise
+		if (h.payload_offset > bytes.size() || h.payload_size > bytes.size() - h.payload_offset)
+		{
+			error = SerializationError::Truncated;
+			return false;
+		}
+		if (!detail::is_aligned(bytes.data() + h.payload_offset, alignment))
+		{
+			error = SerializationError::Misaligned;
+			return false;
+		}
+		return true;
+	}
+
+	private:
+
+	explicit ResultView(const std::byte* record) noexcept : m_record{ record } {}
+
+	ResultRecordHeader header() const noexcept
+	{
+		ResultRecordHeader h;
+		std::memcpy(&h, m_record, sizeof(h));
+		return h;
+	}
+
+	const std::byte* m_record;
+};
+
+/// Number of bytes `encode_results` writes for `results`
+template<typename T, typename E, std::ranges::forward_range R>
+[[nodiscard]] std::size_t encoded_size_of_results(const R& results)
+{
+	constexpr std::size_t alignment = result_record_alignment<T, E>;
+	std::size_t			  count		= static_cast<std::size_t>(std::ranges::distance(results));
+	std::size_t			  size = detail::align_up(sizeof(ResultBatchHeader) + count * sizeof(std::uint64_t),
+											  alignment);
+	for (const OwningResult<T, E>& result : results)
+		size = detail::align_up(size + encoded_size(result), alignment);
+	return size;
+}
+
+/// Writes every result in `results` as one batch to the start of `out` and returns the number of
+/// bytes written. `out` must be aligned to `result_record_alignment<T, E>` and hold at least
+/// `encoded_size_of_results<T, E>(results)` bytes.
+template<typename T, typename E, std::ranges::forward_range R>
+std::size_t encode_results(const R& results, std::span<std::byte> out)
+{
+	constexpr std::size_t alignment = result_record_alignment<T, E>;
+	std::size_t			  total		= encoded_size_of_results<T, E>(results);
+	ASSERT(out.size() >= total, "output buffer too small to encode results");
+	ASSERT(detail::is_aligned(out.data(), alignment), "output buffer is not aligned for results");
+
+	ResultBatchHeader header{};
+	header.magic	  = result_batch_magic;
+	header.version	  = result_format_version;
+	header.count	  = static_cast<std::uint64_t>(std::ranges::distance(results));
+	header.total_size = total;
+	std::memcpy(out.data(), &header, sizeof(header));
+
+	std::size_t offsets	 = sizeof(ResultBatchHeader);
+	std::size_t position =
+		detail::align_up(offsets + header.count * sizeof(std::uint64_t), alignment);
+	for (const OwningResult<T, E>& result : results)
+	{
+		std::uint64_t offset = position;
+		std::memcpy(out.data() + offsets, &offset, sizeof(offset));
+		offsets += sizeof(offset);
+		position = detail::align_up(position + encode_result(result, out.subspan(position)), alignment);
+	}
+	return total;
+}
+
+template<typename T, typename E, std::ranges::forward_range R>
+[[nodiscard]] std::vector<std::byte> encode_results(const R& results)
+{
+	static_assert(result_record_alignment<T, E> <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+				  "over-aligned payloads need a caller provided buffer");
+	std::vector<std::byte> bytes(encoded_size_of_results<T, E>(results));
+	encode_results<T, E>(results, std::span<std::byte>(bytes));
+	return bytes;
+}
+
+/// Borrowed view of a batch written by `encode_results`.
+/// Every record is validated once by `from_bytes`, after which indexing is a bounds check and an
+/// offset lookup. The view does not own the bytes, they have to outlive it.
+template<ResultEncodable T, ResultEncodable E>
+class ResultBatchView
+{
+	public:
+
+	[[nodiscard]] static OwningResult<ResultBatchView, SerializationError>
+	from_bytes(std::span<const std::byte> bytes)
+	{
+		if (bytes.size() < sizeof(ResultBatchHeader))
+			return OwningErr<SerializationError>(SerializationError::Truncated);
+		if (!detail::is_aligned(bytes.data(), result_record_alignment<T, E>))
+			return OwningErr<SerializationError>(SerializationError::Misaligned);
+
+		ResultBatchHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.magic != result_batch_magic)
+			return OwningErr<SerializationError>(SerializationError::BadMagic);
+		if (header.version != result_format_version)
+			return OwningErr<SerializationError>(SerializationError::UnsupportedVersion);
+		if (header.total_size > bytes.size()
+			|| header.count > (bytes.size() - sizeof(header)) / sizeof(std::uint64_t))
+			return OwningErr<SerializationError>(SerializationError::Truncated);
+
+		bytes = bytes.first(static_cast<std::size_t>(header.total_size));
+		ResultBatchView view(bytes, static_cast<std::size_t>(header.count));
+		for (std::size_t i = 0; i < view.m_count; ++i)
+		{
+			std::uint64_t offset = view.offset(i);
+			if (offset >= bytes.size())
+				return OwningErr<SerializationError>(SerializationError::Truncated);
+			SerializationError error;
+			if (!ResultView<T, E>::validate(bytes.subspan(static_cast<std::size_t>(offset)), error))
+				return OwningErr<SerializationError>(std::move(error));
+		}
+		return OwningOk<ResultBatchView>(std::move(view));
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept { return m_count; }
+
+	/// View of the `index`-th record
+	[[nodiscard]] ResultView<T, E> operator[](std::size_t index) const
+	{
+		ASSERT(index < m_count, "ResultBatchView index out of range");
+		// Every record was validated in from_bytes
+		return ResultView<T, E>(m_bytes.data() + offset(index));
+	}
+
+	private:
+
+	ResultBatchView(std::span<const std::byte> bytes, std::size_t count) noexcept
+		: m_bytes{ bytes },
+		  m_count{ count }
+	{
+	}
+
+	std::uint64_t offset(std::size_t index) const noexcept
+	{
+		std::uint64_t offset;
+		std::memcpy(&offset,
+					m_bytes.data() + sizeof(ResultBatchHeader) + index * sizeof(std::uint64_t),
+					sizeof(offset));
+		return offset;
+	}
+
+	std::span<const std::byte> m_bytes;
+	std::size_t				   m_count;
+};
+
+#endif
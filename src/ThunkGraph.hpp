@@ -0,0 +1,267 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: ThunkGraph.hpp
+// Description: Dependency aware, memoized and parallel evaluation of thunks returning
+//              `OwningResult<T, E>`
+// =================================
+//
+
+#ifndef OL_THUNK_GRAPH_HPP
+#define OL_THUNK_GRAPH_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Assertions.hpp"
+#include "Result.hpp"
+#include "WorkStealingPool.hpp"
+
+/// ThunkGraph is the multi-thunk counterpart of `Thunk<ReturnType>` in LazilyEvaluate.hpp.
+/// Every node is a thunk that declares the nodes it depends on when it is added, and receives
+/// pointers to their values (in the declared order) when it runs.
+/// Since a node can only depend on nodes that were added before it, the graph is always acyclic.
+///
+/// `evaluate` only runs the nodes that the requested outputs transitively depend on and that have
+/// not been evaluated before; nodes whose dependencies are all available are run in parallel on a
+/// `WorkStealingPool`. Every result is memoized, so a node runs at most once.
+/// If a node returns an `OwningErr<E>`, none of its dependents are run: they take on the error of
+/// the failed dependency instead.
+///
+/// Node functions should report failures through their return value. If one throws anyway, the
+/// exception is caught on the worker, its dependents are not run, and `evaluate` rethrows it once
+/// everything else has finished. These nodes are left unevaluated, so a later `evaluate` runs
+/// them again.
+/// `evaluate` must not be called concurrently from several threads.
+template<typename T, typename E>
+class ThunkGraph
+{
+	public:
+
+	using NodeId		= std::size_t;
+	using ThunkInputs	= std::span<const T* const>;
+	using ThunkFunction = std::function<OwningResult<T, E>(ThunkInputs)>;
+
+	explicit ThunkGraph(std::size_t num_threads = std::thread::hardware_concurrency())
+		: m_remaining{ 0 },
+		  m_pool{ num_threads }
+	{
+	}
+
+	/// Adds a thunk to the graph, `dependencies` have to be nodes that are already in the graph.
+	/// Returns the handle used to refer to the new node.
+	NodeId add(ThunkFunction&& func, std::vector<NodeId> dependencies = {})
+	{
+		NodeId id = m_nodes.size();
+		for (NodeId dependency : dependencies)
+			ASSERT(dependency < id, "ThunkGraph dependencies must be added before their dependents");
+
+		Node& node		  = m_nodes.emplace_back();
+		node.func		  = std::move(func);
+		node.dependencies = std::move(dependencies);
+		return id;
+	}
+
+	/// Evaluates every node needed to produce `outputs`, blocking until they are all done
+	void evaluate(std::span<const NodeId> outputs)
+	{
+		std::vector<NodeId> demanded = collect_demanded(outputs);
+		if (demanded.empty()) return;
+
+		// Only wire up the edges between nodes that are going to run in this evaluation
+		for (NodeId id : demanded)
+		{
+			m_nodes[id].dependents.clear();
+			m_nodes[id].exception = nullptr;
+		}
+		std::vector<NodeId> ready;
+		for (NodeId id : demanded)
+		{
+			std::size_t pending = 0;
+			for (NodeId dependency : m_nodes[id].dependencies)
+			{
+				if (m_nodes[dependency].evaluated) continue;
+				m_nodes[dependency].dependents.push_back(id);
+				++pending;
+			}
+			m_nodes[id].pending.store(pending, std::memory_order_relaxed);
+			if (pending == 0) ready.push_back(id);
+		}
+
+		// The ready set has to be known before the first submission, once workers are running
+		// they decrement `pending` and schedule the dependents themselves
+		m_remaining.store(demanded.size(), std::memory_order_relaxed);
+		for (NodeId id : ready)
+			schedule(id);
+
+		std::unique_lock<std::mutex> lock(m_done_mutex);
+		m_done.wait(lock, [this]() { return m_remaining.load(std::memory_order_acquire) == 0; });
+		lock.unlock();
+
+		for (NodeId id : demanded)
+			if (m_nodes[id].exception != nullptr) std::rethrow_exception(m_nodes[id].exception);
+	}
+
+	void evaluate(std::initializer_list<NodeId> outputs)
+	{
+		evaluate(std::span<const NodeId>(outputs.begin(), outputs.size()));
+	}
+
+	void evaluate(NodeId output) { evaluate(std::span<const NodeId>(&output, 1)); }
+
+	[[nodiscard]] std::size_t size(void) const noexcept { return m_nodes.size(); }
+
+	[[nodiscard]] bool is_evaluated(NodeId id) const { return m_nodes[id].evaluated; }
+
+	/// Returns true if the node has been evaluated and produced a value
+	[[nodiscard]] bool is_ok(NodeId id) const
+	{
+		return m_nodes[id].evaluated && m_nodes[id].value.has_value();
+	}
+
+	/// Returns true if the node has been evaluated and it, or one of its dependencies, failed
+	[[nodiscard]] bool is_err(NodeId id) const
+	{
+		return m_nodes[id].evaluated && m_nodes[id].error != nullptr;
+	}
+
+	/// Memoized value of an evaluated node, interrupts execution if the node failed
+	T& get(NodeId id)
+	{
+		ASSERT(is_ok(id), "ThunkGraph::get called on a node without a value");
+		return *m_nodes[id].value;
+	}
+
+	/// Memoized error of an evaluated node, interrupts execution if the node succeeded
+	E& get_err(NodeId id)
+	{
+		ASSERT(is_err(id), "ThunkGraph::get_err called on a node without an error");
+		return *m_nodes[id].error;
+	}
+
+	private:
+
+	struct Node {
+		ThunkFunction			 func;
+		std::vector<NodeId>		 dependencies;
+		std::vector<NodeId>		 dependents;
+		std::atomic<std::size_t> pending{ 0 };
+		std::optional<T>		 value;
+		// Shared so that the dependents of a failed node can report the same error
+		std::shared_ptr<E>		 error;
+		// Thrown by the node or one of its dependencies during the current evaluation
+		std::exception_ptr		 exception;
+		bool					 evaluated{ false };
+	};
+
+	std::vector<NodeId> collect_demanded(std::span<const NodeId> outputs)
+	{
+		std::vector<NodeId> demanded;
+		std::vector<NodeId> stack;
+		std::vector<bool>	visited(m_nodes.size(), false);
+		for (NodeId id : outputs)
+		{
+			ASSERT(id < m_nodes.size(), "ThunkGraph::evaluate called with an unknown node");
+			stack.push_back(id);
+		}
+
+		while (!stack.empty())
+		{
+			NodeId id = stack.back();
+			stack.pop_back();
+			if (visited[id] || m_nodes[id].evaluated) continue;
+			visited[id] = true;
+			demanded.push_back(id);
+			for (NodeId dependency : m_nodes[id].dependencies)
+				stack.push_back(dependency);
+		}
+		return demanded;
+	}
+
+	void schedule(NodeId id)
+	{
+		m_pool.submit([this, id]() { run(id); });
+	}
+
+	void run(NodeId id)
+	{
+		Node& node = m_nodes[id];
+		for (NodeId dependency : node.dependencies)
+		{
+			const Node& input = m_nodes[dependency];
+			if (input.error != nullptr || input.exception != nullptr)
+			{
+				node.error	   = input.error;
+				node.exception = input.exception;
+				break;
+			}
+		}
+
+		if (node.error == nullptr && node.exception == nullptr)
+		{
+			std::vector<const T*> inputs;
+			inputs.reserve(node.dependencies.size());
+			for (NodeId dependency : node.dependencies)
+				inputs.push_back(&*m_nodes[dependency].value);
+
+			// Nothing may escape into the pool's worker thread, evaluate rethrows it instead
+			try
+			{
+				OwningResult<T, E> result = node.func(ThunkInputs(inputs.data(), inputs.size()));
+				if (result.is_ok()) node.value.emplace(result.unwrap());
+				else node.error = std::make_shared<E>(std::move(*result.err()));
+			}
+			catch (...)
+			{
+				node.exception = std::current_exception();
+			}
+		}
+		node.evaluated = node.exception == nullptr;
+
+		// The acq_rel decrements publish this node's result to whichever thread runs a dependent
+		for (NodeId dependent : node.dependents)
+			if (m_nodes[dependent].pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				schedule(dependent);
+
+		if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard<std::mutex> lock(m_done_mutex);
+			m_done.notify_all();
+		}
+	}
+
+	// std::deque keeps nodes in place as the graph grows, they hold atomics and are not movable
+	std::deque<Node>		 m_nodes;
+	std::atomic<std::size_t> m_remaining;
+	std::mutex				 m_done_mutex;
+	std::condition_variable	 m_done;
+	// Declared last so the workers are joined before anything they touch is destroyed
+	WorkStealingPool		 m_pool;
+};
+
+#endif
@@ -0,0 +1,166 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: WorkStealingPool.hpp
+// Description: Fixed size thread pool where each worker owns a task queue and idle workers
+//              steal from the queues of busy ones
+// =================================
+//
+
+#ifndef OL_WORK_STEALING_POOL_HPP
+#define OL_WORK_STEALING_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// WorkStealingPool runs submitted tasks on a fixed number of worker threads.
+/// Every worker has its own queue: it pops the most recently pushed task from the back of its
+/// own queue (good cache locality for tasks spawning tasks) and, when that is empty, steals the
+/// oldest task from the front of another worker's queue.
+/// Tasks submitted from a worker thread go to that worker's queue, tasks submitted from any other
+/// thread are distributed round-robin.
+class WorkStealingPool
+{
+	public:
+
+	explicit WorkStealingPool(std::size_t num_threads = std::thread::hardware_concurrency())
+		: m_pending{ 0 },
+		  m_next_queue{ 0 },
+		  m_stop{ false }
+	{
+		num_threads = std::max<std::size_t>(num_threads, 1);
+		for (std::size_t i = 0; i < num_threads; ++i)
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		for (std::size_t i = 0; i < num_threads; ++i)
+			m_threads.emplace_back([this, i]() { worker_loop(i); });
+	}
+
+	WorkStealingPool(const WorkStealingPool&)			 = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	/// Finishes the tasks that are already queued and joins all workers
+	~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (auto& thread : m_threads)
+			thread.join();
+	}
+
+	/// Queues `task` for execution on one of the workers
+	void submit(std::function<void()>&& task)
+	{
+		std::size_t index = (t_owner == this)
+							  ? t_index
+							  : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+		// Count the task before publishing it so that a worker stealing it straight away never
+		// observes a negative number of pending tasks
+		{
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+			m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+			m_queues[index]->tasks.push_back(std::move(task));
+		}
+		m_wake.notify_one();
+	}
+
+	[[nodiscard]] std::size_t size(void) const noexcept { return m_threads.size(); }
+
+	private:
+
+	struct WorkQueue {
+		std::mutex						  mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	bool try_pop(std::size_t index, std::function<void()>& task)
+	{
+		// Own queue first, newest task
+		{
+			std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+			if (!m_queues[index]->tasks.empty())
+			{
+				task = std::move(m_queues[index]->tasks.back());
+				m_queues[index]->tasks.pop_back();
+				m_pending.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		// Then steal the oldest task from the other workers
+		for (std::size_t offset = 1; offset < m_queues.size(); ++offset)
+		{
+			WorkQueue&					victim = *m_queues[(index + offset) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				m_pending.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void worker_loop(std::size_t index)
+	{
+		t_owner = this;
+		t_index = index;
+
+		std::function<void()> task;
+		while (true)
+		{
+			if (try_pop(index, task))
+			{
+				task();
+				task = nullptr;
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleep_mutex);
+			m_wake.wait(lock, [this]() { return m_stop || m_pending.load() > 0; });
+			if (m_stop && m_pending.load() == 0) return;
+		}
+	}
+
+	static inline thread_local WorkStealingPool* t_owner = nullptr;
+	static inline thread_local std::size_t		 t_index = 0;
+
+	std::vector<std::unique_ptr<WorkQueue>> m_queues;
+	std::vector<std::thread>				m_threads;
+	std::atomic<std::size_t>				m_pending;
+	std::atomic<std::size_t>				m_next_queue;
+	std::mutex								m_sleep_mutex;
+	std::condition_variable					m_wake;
+	bool									m_stop;
+};
+
+#endif
@@ -0,0 +1,135 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// =================================
+// Author: Kevin Ingles
+// File: Zip.hpp
+// Description: Combines several `OwningResult`s into one with a single branch, and `match` to
+//              visit the outcome
+// =================================
+//
+
+#ifndef OL_ZIP_HPP
+#define OL_ZIP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Result.hpp"
+
+namespace detail
+{
+	template<typename R>
+	struct is_owning_result : std::false_type {
+	};
+
+	template<typename T, typename E, LikelihoodPolicy Likelihood, CheckingPolicy Checking>
+	struct is_owning_result<OwningResult<T, E, Likelihood, Checking>> : std::true_type {
+	};
+
+	template<typename T, typename Func>
+	struct is_applicable : std::false_type {
+	};
+
+	template<typename... Ts, typename Func>
+	struct is_applicable<std::tuple<Ts...>, Func> : std::is_invocable<Func, Ts&&...> {
+	};
+} // namespace detail
+
+template<typename R>
+concept AnyOwningResult = detail::is_owning_result<std::remove_cvref_t<R>>::value;
+
+/// True if every result holds an Ok value.
+/// The flags are combined with a bitwise AND rather than `&&`, so there is one branch for the
+/// caller to take instead of one per result.
+template<AnyOwningResult... Results>
+[[nodiscard]] bool all_ok(const Results&... results) noexcept
+{
+	return (static_cast<unsigned>(results.is_ok()) & ... & 1u) != 0;
+}
+
+/// Index of the first result holding an Err value, `sizeof...(results)` if there is none
+template<AnyOwningResult... Results>
+[[nodiscard]] std::size_t first_err_index(const Results&... results) noexcept
+{
+	std::size_t index = 0;
+	(void)((results.is_err() ? true : (++index, false)) || ...);
+	return index;
+}
+
+/// Combines results sharing the error type `E` into one `OwningResult<std::tuple<Ts...>, E>`.
+/// If all of them are Ok, their values are moved into the tuple. Otherwise the error of the
+/// first result (by position) holding one is returned and the rest are left as they are.
+/// Consumes the Ok values on success and the returned error on failure.
+template<AnyOwningResult First, AnyOwningResult... Rest>
+[[nodiscard]] auto zip(First&& first, Rest&&... rest)
+{
+	using E			 = typename std::remove_cvref_t<First>::error_type;
+	using Likelihood = typename std::remove_cvref_t<First>::likelihood_policy;
+	using Checking	 = typename std::remove_cvref_t<First>::checking_policy;
+	using Tuple		 = std::tuple<typename std::remove_cvref_t<First>::value_type,
+							  typename std::remove_cvref_t<Rest>::value_type...>;
+	using Zipped	 = OwningResult<Tuple, E, Likelihood, Checking>;
+	static_assert((std::is_same_v<typename std::remove_cvref_t<Rest>::error_type, E> && ...),
+				  "zip needs results that share an error type");
+	static_assert(!std::is_void_v<E> && !std::is_void_v<std::tuple_element_t<0, Tuple>>
+					  && (!std::is_void_v<typename std::remove_cvref_t<Rest>::value_type> && ...),
+				  "zip needs results with both a value and an error type");
+
+	if (detail::predict_ok<Likelihood>(all_ok(first, rest...)))
+		return Zipped(OwningOk<Tuple>(Tuple{ first.unwrap(), rest.unwrap()... }));
+
+	std::optional<E> error;
+	auto			 take_first_error = [&error](auto& result) {
+		if (!result.is_err()) return false;
+		error.emplace(*result.err());
+		return true;
+	};
+	(void)(take_first_error(first) || ... || take_first_error(rest));
+	return Zipped(OwningErr<E>(std::move(*error)));
+}
+
+/// Visits a result: calls `on_ok` with its value or `on_err` with its error, and consumes it.
+/// For `OwningResult<T, void>` there is no error to pass, `on_err` is called without arguments.
+/// A tuple value, e.g. the result of `zip`, is unpacked into separate arguments when `on_ok`
+/// takes them, and otherwise passed whole to be taken apart with a structured binding.
+template<AnyOwningResult Result, typename OkFunc, typename ErrFunc>
+decltype(auto) match(Result&& result, OkFunc&& on_ok, ErrFunc&& on_err)
+{
+	using T			 = typename std::remove_cvref_t<Result>::value_type;
+	using E			 = typename std::remove_cvref_t<Result>::error_type;
+	using Likelihood = typename std::remove_cvref_t<Result>::likelihood_policy;
+
+	if (detail::predict_ok<Likelihood>(result.is_ok()))
+	{
+		if constexpr (std::is_void_v<T>)
+		{
+			result.unwrap();
+			return std::invoke(std::forward<OkFunc>(on_ok));
+		}
+		else if constexpr (detail::is_applicable<T, OkFunc>::value
+						   && !std::is_invocable_v<OkFunc, T&&>)
+			return std::apply(std::forward<OkFunc>(on_ok), result.unwrap());
+		else return std::invoke(std::forward<OkFunc>(on_ok), result.unwrap());
+	}
+	else if constexpr (std::is_void_v<E>) return std::invoke(std::forward<ErrFunc>(on_err));
+	else return std::invoke(std::forward<ErrFunc>(on_err), *result.err());
+}
+
+#endif
@@ -0,0 +1,133 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Bridge_test.cpp
+//    Description: Checks the conversions between OwningResult, std::expected and exceptions
+//    =================================
+
+#include "Bridge.hpp"
+#include "test.hpp"
+
+#include <stdexcept>
+#include <string>
+
+void check_Bridge_expected_round_trip(void);
+void check_Bridge_try_invoke(void);
+void check_Bridge_or_throw(void);
+
+int main()
+{
+	check_Bridge_expected_round_trip();
+	check_Bridge_try_invoke();
+	check_Bridge_or_throw();
+	return test_exit_code();
+}
+
+void check_Bridge_expected_round_trip(void)
+{
+#ifdef OL_HAS_EXPECTED
+	std::size_t failures = failed_checks();
+
+	OwningResult<std::string, int>	ok		 = OwningOk<std::string>(std::string("payload"));
+	std::expected<std::string, int> expected = to_expected(std::move(ok));
+	EXPECT_TRUE(expected.has_value() && *expected == "payload");
+
+	OwningResult<std::string, int> back = from_expected(std::move(expected));
+	EXPECT_TRUE(back.is_ok() && back.unwrap() == "payload");
+
+	std::expected<std::string, int> failed = std::unexpected(42);
+	OwningResult<std::string, int>	err	   = from_expected(std::move(failed));
+	EXPECT_TRUE(to_expected(std::move(err)).error() == 42);
+	PrintResult("Bridge round trips std::expected:", failures);
+#else
+	PrintLn("Bridge round trips std::expected: \033[01;33m[Skipped, no std::expected]\033[0m");
+#endif
+}
+
+void check_Bridge_try_invoke(void)
+{
+	std::size_t failures = failed_checks();
+
+	auto ok = try_invoke([]() { return std::stoi("12"); });
+	EXPECT_TRUE(ok.is_ok() && ok.unwrap() == 12);
+
+	auto caught = try_invoke([]() { return std::stoi("twelve"); });
+	EXPECT_TRUE(caught.is_err());
+
+	auto mapped = try_invoke([]() { return std::stoi("twelve"); },
+							 [](const std::exception& exception) {
+								 return std::string(exception.what());
+							 });
+	EXPECT_TRUE(mapped.is_err() && mapped.err() == "stoi");
+
+	auto everything = try_invoke([]() -> int { throw 7; },
+								 [](std::exception_ptr exception) {
+									 try
+									 {
+										 std::rethrow_exception(exception);
+									 }
+									 catch (int code)
+									 {
+										 return code;
+									 }
+								 });
+	EXPECT_TRUE(everything.err() == 7);
+	PrintResult("Bridge try_invoke captures exceptions:", failures);
+}
+
+void check_Bridge_or_throw(void)
+{
+	std::size_t failures = failed_checks();
+
+	EXPECT_TRUE(or_throw(OwningResult<int, int>(OwningOk<int>(3))) == 3);
+
+	bool thrown = false;
+	try
+	{
+		[[maybe_unused]] int value = or_throw(OwningResult<int, int>(OwningErr<int>(5)));
+	}
+	catch (BadResultAccess<int>& exception)
+	{
+		thrown = exception.error() == 5;
+	}
+	EXPECT_TRUE(thrown);
+
+	thrown = false;
+	try
+	{
+		OwningErr<std::runtime_error>		  io_error(std::runtime_error("io"));
+		OwningResult<int, std::runtime_error> failure(std::move(io_error));
+		[[maybe_unused]] int				  value = or_throw(std::move(failure));
+	}
+	catch (std::runtime_error& exception)
+	{
+		thrown = std::string(exception.what()) == "io";
+	}
+	EXPECT_TRUE(thrown);
+
+	thrown = false;
+	try
+	{
+		[[maybe_unused]] int value = or_throw(try_invoke([]() { return std::stoi("x"); }));
+	}
+	catch (std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+	PrintResult("Bridge or_throw throws errors:", failures);
+}
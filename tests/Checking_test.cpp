@@ -0,0 +1,225 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Checking_test.cpp
+//    Description: Checks that each checking level detects the misuse it claims to and that the
+//                 lower levels drop the consumed flag
+//    =================================
+
+#include "Result.hpp"
+#include "test.hpp"
+
+#include <csignal>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+template<typename T, typename E, typename Checking>
+using Checked = OwningResult<T, E, OkLikely, Checking>;
+
+struct Empty {
+};
+
+// Below full checks the consumed flag is gone from the layout. With boxed payloads it only
+// frees padding, with stateless ones it shows in the size
+using EmptyFull	 = Checked<Empty, Empty, FullChecks>;
+using EmptyLight = Checked<Empty, Empty, LightChecks>;
+using EmptyNone	 = Checked<Empty, Empty, NoChecks>;
+static_assert(sizeof(EmptyLight) + 1 == sizeof(EmptyFull));
+static_assert(sizeof(EmptyNone) == sizeof(EmptyLight));
+static_assert(std::is_same_v<OwningResult<int, int>::checking_policy, DefaultChecking>);
+static_assert(std::is_same_v<DefaultChecking, FullChecks>);
+
+void check_Checking_full(void);
+void check_Checking_light(void);
+void check_Checking_none(void);
+
+int main()
+{
+	check_Checking_full();
+	check_Checking_light();
+	check_Checking_none();
+	return test_exit_code();
+}
+
+// Runs `func` in a child process and reports whether it ended in std::terminate
+bool terminates(const std::function<void(void)>& func)
+{
+	std::cout.flush();
+	pid_t child = fork();
+	if (child == 0)
+	{
+		// The assertion message is expected, keep it out of the test output
+		if (std::freopen("/dev/null", "w", stderr) == nullptr) _exit(2);
+		func();
+		_exit(0);
+	}
+	int status = 0;
+	waitpid(child, &status, 0);
+	return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+// Correct use behaves the same at every level
+template<typename Checking>
+bool behaves_normally(void)
+{
+	Checked<std::string, int, Checking> ok = OwningOk<std::string>(std::string("value"));
+	Checked<std::string, int, Checking> err = OwningErr<int>(3);
+	bool same = ok.is_ok() && *ok.peek_ok() == "value" && ok.unwrap() == "value";
+	same	  = same && err.is_err() && *err.peek_err() == 3 && err.err() == 3;
+
+	Checked<int, int, Checking> mapped = OwningOk<int>(2);
+	same = same && mapped.template map<int>([](int& v) { return v * 10; }).unwrap() == 20;
+
+	Checked<void, int, Checking> status = OwningOk<void>();
+	Checked<int, void, Checking> maybe	= OwningOk<int>(4);
+	return same && status.is_ok() && maybe.unwrap() == 4;
+}
+
+// The error is heap allocated, destroying it twice would corrupt the heap
+template<typename Checking>
+bool second_err_is_empty(void)
+{
+	Checked<void, std::string, Checking> status = OwningErr<std::string>(std::string(64, 'e'));
+	std::optional<std::string>			 first	= status.err();
+	std::optional<std::string>			 second = status.err();
+	return first == std::string(64, 'e') && !second && status.peek_err() == nullptr
+		&& !status.is_err_and([](std::string&) { return true; });
+}
+
+void check_Checking_full(void)
+{
+	std::size_t failures = failed_checks();
+	using Full			 = Checked<int, int, FullChecks>;
+
+	EXPECT_TRUE(behaves_normally<FullChecks>());
+
+	// Unwrapping the wrong side
+	EXPECT_TRUE(terminates([]() {
+		Full result = OwningErr<int>(1);
+		(void)result.unwrap();
+	}));
+	EXPECT_TRUE(terminates([]() {
+		Checked<void, int, FullChecks> status = OwningErr<int>(1);
+		status.expect("failed");
+	}));
+
+	// Using a consumed result
+	EXPECT_TRUE(terminates([]() {
+		Full result = OwningOk<int>(1);
+		(void)result.unwrap();
+		(void)result.unwrap();
+	}));
+	EXPECT_TRUE(terminates([]() {
+		Full result = OwningOk<int>(1);
+		(void)result.ok();
+		(void)result.map<int>([](int& v) { return v; });
+	}));
+	EXPECT_TRUE(terminates([]() {
+		Checked<int, void, FullChecks> maybe = OwningOk<int>(1);
+		(void)maybe.unwrap();
+		(void)maybe.unwrap();
+	}));
+
+	// Mapping consumes either side of the void specializations, like the general template
+	EXPECT_TRUE(terminates([]() {
+		Checked<void, int, FullChecks> status = OwningOk<void>();
+		(void)status.map<int>([]() { return 1; });
+		(void)status.map<int>([]() { return 2; });
+	}));
+	EXPECT_TRUE(terminates([]() {
+		Checked<int, void, FullChecks> maybe = OwningErr<void>();
+		(void)maybe.map<int>([](int& v) { return v; });
+		(void)maybe.map<int>([](int& v) { return v; });
+	}));
+	Checked<void, int, FullChecks> mapped_status = OwningOk<void>();
+	EXPECT_TRUE(mapped_status.map<int>([]() { return 7; }).unwrap() == 7);
+	Checked<int, void, FullChecks> mapped_maybe = OwningErr<void>();
+	EXPECT_TRUE(mapped_maybe.map<int>([](int& v) { return v; }).is_err());
+	EXPECT_TRUE(mapped_status.is_ok() && mapped_maybe.is_err());
+
+	// Queries on a consumed result answer instead of terminating
+	Full consumed = OwningOk<int>(5);
+	(void)consumed.unwrap();
+	EXPECT_TRUE(!consumed.ok() && !consumed.err() && consumed.peek_ok() == nullptr);
+
+	Checked<void, int, FullChecks> status = OwningErr<int>(6);
+	(void)status.err();
+	EXPECT_TRUE(!status.err() && status.peek_err() == nullptr);
+
+	// A moved-from result counts as consumed
+	using Text = Checked<std::string, int, FullChecks>;
+	EXPECT_TRUE(terminates([]() {
+		Text source = OwningOk<std::string>(std::string("moved"));
+		Text target = std::move(source);
+		(void)source.unwrap();
+	}));
+	Text source = OwningOk<std::string>(std::string("moved"));
+	Text target = std::move(source);
+	EXPECT_TRUE(!source.ok() && !source.err() && source.peek_ok() == nullptr);
+	EXPECT_TRUE(target.unwrap() == "moved");
+	PrintResult("FullChecks detects wrong side and consumed use:", failures);
+}
+
+void check_Checking_light(void)
+{
+	std::size_t failures = failed_checks();
+
+	EXPECT_TRUE(behaves_normally<LightChecks>());
+
+	// Unwrapping the wrong side is still caught
+	EXPECT_TRUE(terminates([]() {
+		Checked<int, int, LightChecks> result = OwningErr<int>(1);
+		(void)result.unwrap();
+	}));
+	EXPECT_TRUE(terminates([]() {
+		Checked<void, int, LightChecks> status = OwningErr<int>(1);
+		status.unwrap();
+	}));
+	EXPECT_TRUE(terminates([]() {
+		Checked<int, void, LightChecks> maybe = OwningErr<void>();
+		(void)maybe.expect("failed");
+	}));
+
+	// The state of inline results is kept at every level, consuming the error twice is safe
+	EXPECT_TRUE(second_err_is_empty<LightChecks>());
+
+	// Consumption is not tracked: the side decides, the earlier unwrap is not remembered
+	Checked<int, int, LightChecks> consumed = OwningOk<int>(5);
+	(void)consumed.unwrap();
+	EXPECT_TRUE(consumed.is_ok() && consumed.peek_ok() == nullptr && !consumed.err());
+	PrintResult("LightChecks detects unwrapping the wrong side:", failures);
+}
+
+void check_Checking_none(void)
+{
+	std::size_t failures = failed_checks();
+
+	EXPECT_TRUE(behaves_normally<NoChecks>());
+	EXPECT_TRUE(second_err_is_empty<NoChecks>());
+
+	// Nothing is checked: unwrapping an error result with no value is a no-op, not a failure
+	EXPECT_TRUE(!terminates([]() {
+		Checked<void, int, NoChecks> status = OwningErr<int>(1);
+		status.unwrap();
+	}));
+	PrintResult("NoChecks checks nothing:", failures);
+}
@@ -0,0 +1,213 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: MappedFile_test.cpp
+//    Description: Checks opening errors, and that lines and records of a mapped temporary file
+//                 are handed out without copies
+//    =================================
+
+#include "MappedFile.hpp"
+#include "instrumentation.hpp"
+
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <ranges>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+
+static_assert(std::ranges::input_range<MappedFile::Lines>);
+static_assert(std::ranges::input_range<MappedFile::Records>);
+
+void check_MappedFile_open_errors(void);
+void check_MappedFile_lines(void);
+void check_MappedFile_records(void);
+void check_MappedFile_results_outlive_iterators(void);
+
+int main()
+{
+	check_MappedFile_open_errors();
+	check_MappedFile_lines();
+	check_MappedFile_records();
+	check_MappedFile_results_outlive_iterators();
+	return test_exit_code();
+}
+
+// Writes `contents` to a uniquely named file in the temporary directory, so concurrent runs do
+// not clobber each other, and removes it again on destruction
+class TempFile
+{
+	public:
+
+	TempFile(const std::string& stem, const std::string& contents)
+	{
+		std::string name = (std::filesystem::temp_directory_path() / stem).string();
+#if defined(__unix__) || defined(__APPLE__)
+		name += "-XXXXXX";
+		int fd = mkstemp(name.data());
+		if (fd < 0)
+		{
+			std::error_code error(errno, std::generic_category());
+			throw std::filesystem::filesystem_error("cannot create a temporary file", name, error);
+		}
+		close(fd);
+#else
+		name += "-" + std::to_string(std::random_device{}());
+#endif
+		m_path = name;
+		std::ofstream out(m_path, std::ios::binary);
+		out << contents;
+	}
+
+	~TempFile(void)
+	{
+		std::error_code ignored;
+		std::filesystem::remove(m_path, ignored);
+	}
+
+	TempFile(const TempFile&)			 = delete;
+	TempFile& operator=(const TempFile&) = delete;
+
+	const std::filesystem::path& path(void) const noexcept { return m_path; }
+
+	private:
+
+	std::filesystem::path m_path;
+};
+
+std::vector<std::string> collect_lines(const MappedFile& file)
+{
+	std::vector<std::string> lines;
+	for (auto line : file.lines())
+		lines.emplace_back(line.unwrap());
+	return lines;
+}
+
+void check_MappedFile_open_errors(void)
+{
+	std::size_t failures = failed_checks();
+
+	auto missing = MappedFile::open(std::filesystem::temp_directory_path() / "ol_does_not_exist");
+	EXPECT_TRUE(missing.is_err());
+	IoError error = *missing.err();
+	EXPECT_TRUE(error.kind == IoError::Kind::open && error.error_number == ENOENT);
+	EXPECT_TRUE(error.message().find("open failed") == 0);
+
+	// An empty file is not an error, just empty
+	TempFile   empty("ol_mapped_empty", "");
+	MappedFile mapped = MappedFile::open(empty.path()).unwrap();
+	EXPECT_TRUE(mapped.size() == 0 && mapped.lines().begin() == std::default_sentinel);
+	PrintResult("MappedFile reports open and map failures as errors:", failures);
+}
+
+void check_MappedFile_lines(void)
+{
+	std::size_t failures = failed_checks();
+
+	TempFile   text("ol_mapped_lines", "first\n\nthird\r\nlast without newline");
+	MappedFile file = MappedFile::open(text.path(), MapOptions{ true, true }).unwrap();
+	EXPECT_TRUE(file.contents().size() == 34);
+	EXPECT_TRUE((collect_lines(file)
+				 == std::vector<std::string>{ "first", "", "third\r", "last without newline" }));
+
+	// Lines point into the mapping, iterating them neither copies nor allocates
+	bool		inside = true;
+	std::size_t count  = 0;
+	EXPECT_ALLOCS(0, for (auto line : file.lines()) {
+		inside = inside && line.unwrap().data() >= file.data()
+			  && line.unwrap().data() + line.unwrap().size() <= file.data() + file.size();
+		++count;
+	});
+	EXPECT_TRUE(inside && count == 4);
+
+	TempFile   trailing("ol_mapped_trailing", "a\nb\n");
+	MappedFile trailing_file = MappedFile::open(trailing.path()).unwrap();
+	EXPECT_TRUE((collect_lines(trailing_file) == std::vector<std::string>{ "a", "b" }));
+
+	// The mapping moves with the MappedFile
+	MappedFile moved(std::move(trailing_file));
+	EXPECT_TRUE(trailing_file.data() == nullptr && moved.contents() == "a\nb\n");
+	PrintResult("MappedFile iterates lines without copying:", failures);
+}
+
+void check_MappedFile_records(void)
+{
+	std::size_t failures = failed_checks();
+
+	TempFile   binary("ol_mapped_records", "abcdefghij");
+	MappedFile file = MappedFile::open(binary.path()).unwrap();
+
+	std::vector<std::string> records;
+	std::size_t				 truncated_at = 0;
+	for (auto record : file.records(4))
+	{
+		if (record.is_ok()) records.emplace_back(record.unwrap());
+		else if (record.peek_err()->kind == IoError::Kind::truncated_record)
+			truncated_at = record.peek_err()->offset;
+	}
+	EXPECT_TRUE((records == std::vector<std::string>{ "abcd", "efgh" }) && truncated_at == 8);
+
+	std::size_t whole = 0;
+	for (auto record : file.records(5))
+		whole += record.is_ok();
+	EXPECT_TRUE(whole == 2);
+	PrintResult("MappedFile iterates fixed size records:", failures);
+}
+
+void check_MappedFile_results_outlive_iterators(void)
+{
+	std::size_t failures = failed_checks();
+
+	TempFile   text("ol_mapped_kept", "one\ntwo\nthree\n");
+	MappedFile file = MappedFile::open(text.path()).unwrap();
+
+	// The iterator is a temporary, the result must not point into it
+	MappedFile::ViewResult first = *file.lines().begin();
+	EXPECT_TRUE(first.unwrap() == "one");
+
+	// Results collected from one loop stay distinct
+	std::vector<MappedFile::ViewResult> lines;
+	for (auto line : file.lines())
+		lines.push_back(line);
+	EXPECT_TRUE(lines.size() == 3 && lines[0].unwrap() == "one" && lines[1].unwrap() == "two"
+				&& lines[2].unwrap() == "three");
+
+	// A record and a truncation error kept past `++` and past the end of the iterator
+	std::vector<MappedFile::ViewResult> records;
+	{
+		auto it = file.records(5).begin();
+		records.push_back(*it);
+		++it;
+		records.push_back(*it);
+		++it;
+		records.push_back(*it);
+		++it;
+		EXPECT_TRUE(it == std::default_sentinel);
+	}
+	EXPECT_TRUE(records[0].unwrap() == "one\nt" && records[1].unwrap() == "wo\nth");
+	EXPECT_TRUE(records[2].is_err()
+				&& records[2].unwrap_err().kind == IoError::Kind::truncated_record
+				&& records[2].unwrap_err().offset == 10);
+	PrintResult("MappedFile results stay valid after the iterator moves on:", failures);
+}
@@ -0,0 +1,164 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    =================================
+//    Author: Kevin Ingles
+//    File: Memoize_test.cpp
+//    Description: Checks caching, negative caching, eviction and single-flight of memoize
+//    =================================
+
+#include "Memoize.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+void check_Memoize_hits_and_misses(void);
+void check_Memoize_negative_caching(void);
+void check_Memoize_eviction(void);
+void check_Memoize_single_flight(void);
+
+int main()
+{
+	check_Memoize_hits_and_misses();
+	check_Memoize_negative_caching();
+	check_Memoize_eviction();
+	check_Memoize_single_flight();
+	return test_exit_code();
+}
+
+// Odd keys fail
+OwningResult<std::string, int> lookup(const int& key)
+{
+	if (key % 2 == 1) return OwningErr<int>(int{ key });
+	return OwningOk<std::string>(std::to_string(key));
+}
+
+void check_Memoize_hits_and_misses(void)
+{
+	std::size_t failures = failed_checks();
+	int			calls	 = 0;
+	auto		counted	 = [&calls](const int& key) { ++calls; return lookup(key); };
+	auto		cached	 = memoize<int, std::string, int>(counted);
+
+	EXPECT_TRUE(cached(2).unwrap() == "2");
+	EXPECT_TRUE(cached(2).unwrap() == "2");
+	EXPECT_TRUE(cached(4).unwrap() == "4");
+	EXPECT_TRUE(calls == 2);
+
+	MemoizeStats stats = cached.stats();
+	EXPECT_TRUE(stats.hits == 1 && stats.misses == 2 && stats.negative_hits == 0);
+	PrintResult("memoize caches Ok values:", failures);
+}
+
+void check_Memoize_negative_caching(void)
+{
+	std::size_t	  failures = failed_checks();
+	int			  calls	   = 0;
+	auto		  counted  = [&calls](const int& key) { ++calls; return lookup(key); };
+	MemoizeConfig config;
+	config.err_ttl = std::chrono::hours(1);
+	auto cached	   = memoize<int, std::string, int>(counted, config);
+
+	// The TTL is long enough that a slow machine cannot outlast it between the calls
+	EXPECT_TRUE(*cached(3).err() == 3);
+	EXPECT_TRUE(*cached(3).err() == 3);
+	EXPECT_TRUE(calls == 1 && cached.stats().negative_hits == 1);
+
+	// Once the TTL passed the function is tried again, the sleep is far longer than the TTL
+	MemoizeConfig short_lived;
+	short_lived.err_ttl = std::chrono::milliseconds(1);
+	calls				= 0;
+	auto expiring		= memoize<int, std::string, int>(counted, short_lived);
+	EXPECT_TRUE(expiring(3).is_err());
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_TRUE(expiring(3).is_err());
+	EXPECT_TRUE(calls == 2 && expiring.stats().negative_hits == 0);
+
+	// The capacity bounds the errors cached over all shards, not in each of them
+	MemoizeConfig single;
+	single.num_shards	= 16;
+	single.err_capacity = 1;
+	single.err_ttl		= std::chrono::hours(1);
+	auto bounded		= memoize<int, std::string, int>(counted, single);
+	for (int round = 0; round < 2; ++round)
+		for (int key = 1; key < 64; key += 2)
+			(void)bounded(key);
+	EXPECT_TRUE(bounded.stats().negative_hits <= 1);
+
+	// Without negative caching every failing call is retried
+	config.err_capacity = 0;
+	calls				= 0;
+	auto uncached		= memoize<int, std::string, int>(counted, config);
+	for (int i = 0; i < 3; ++i)
+		EXPECT_TRUE(uncached(5).is_err());
+	EXPECT_TRUE(calls == 3);
+	PrintResult("memoize caches Err values with a TTL:", failures);
+}
+
+void check_Memoize_eviction(void)
+{
+	std::size_t	  failures = failed_checks();
+	int			  calls	   = 0;
+	auto		  counted  = [&calls](const int& key) { ++calls; return lookup(key); };
+	MemoizeConfig config;
+	config.num_shards  = 1;
+	config.ok_capacity = 4;
+	auto cached		   = memoize<int, std::string, int>(counted, config);
+
+	for (int key = 0; key < 8; key += 2)
+		(void)cached(key);
+	// Key 0 gets its second chance, so key 2 is the one evicted for key 8
+	(void)cached(0);
+	(void)cached(8);
+	EXPECT_TRUE(cached.stats().evictions == 1);
+
+	calls = 0;
+	(void)cached(0);
+	EXPECT_TRUE(calls == 0);
+	(void)cached(2);
+	EXPECT_TRUE(calls == 1);
+	PrintResult("memoize evicts with CLOCK:", failures);
+}
+
+void check_Memoize_single_flight(void)
+{
+	std::size_t		 failures = failed_checks();
+	std::atomic<int> calls{ 0 };
+	auto			 slow = [&calls](const int& key) {
+		++calls;
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		return lookup(key);
+	};
+	auto cached = memoize<int, std::string, int>(slow);
+
+	std::vector<std::thread> threads;
+	std::atomic<int>		 correct{ 0 };
+	for (int i = 0; i < 4; ++i)
+		threads.emplace_back([&]() {
+			if (cached(6).unwrap() == "6") ++correct;
+		});
+	for (auto& thread : threads)
+		thread.join();
+
+	MemoizeStats stats = cached.stats();
+	EXPECT_TRUE(calls == 1 && correct == 4);
+	EXPECT_TRUE(stats.misses == 1 && stats.hits + stats.coalesced == 3);
+	PrintResult("memoize runs concurrent misses once:", failures);
+}
@@ -0,0 +1,130 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    =================================
+//    Author: Kevin Ingles
+//    File: MultiErr_test.cpp
+//    Description: Checks error accumulation, overflow counting and arena spill of MultiErr, and
+//                 the validate_all combinator
+//    =================================
+
+#include "MultiErr.hpp"
+#include "instrumentation.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+using Status = OwningResult<void, int>;
+
+void check_MultiErr_inline_and_overflow(void);
+void check_MultiErr_arena_spill(void);
+void check_MultiErr_validate_all(void);
+
+int main()
+{
+	check_MultiErr_inline_and_overflow();
+	check_MultiErr_arena_spill();
+	check_MultiErr_validate_all();
+	return test_exit_code();
+}
+
+void check_MultiErr_inline_and_overflow(void)
+{
+	std::size_t failures = failed_checks();
+
+	// Without an arena nothing is ever allocated, errors past the inline capacity are counted
+	AllocationScope	   allocations;
+	MultiErr<int, 4>   errors;
+	for (int i = 0; i < 10; ++i)
+		errors.push(std::move(i));
+	EXPECT_TRUE(allocations.allocations() == 0);
+	EXPECT_TRUE(errors.size() == 4 && errors.dropped() == 6 && errors.total() == 10);
+	EXPECT_TRUE(errors[0] == 0 && errors[3] == 3);
+
+	int sum = 0;
+	for (int error : errors)
+		sum += error;
+	EXPECT_TRUE(sum == 6);
+
+	// Errors with state are moved in and out, never copied, and all destroyed
+	TrackedScope tracked;
+	{
+		MultiErr<Tracked, 2> tracked_errors;
+		for (int i = 0; i < 3; ++i)
+			tracked_errors.push(Tracked(i));
+		MultiErr<Tracked, 2> moved(std::move(tracked_errors));
+		EXPECT_TRUE(moved.size() == 2 && moved[1].value() == 1 && tracked_errors.empty());
+	}
+	EXPECT_TRUE(tracked.copies() == 0 && tracked.alive() == 0);
+	PrintResult("MultiErr keeps the first N errors and counts the rest:", failures);
+}
+
+void check_MultiErr_arena_spill(void)
+{
+	std::size_t failures = failed_checks();
+
+	// A stack buffer backed arena keeps spilling off the global heap too
+	std::array<std::byte, 4096>			buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+											  std::pmr::null_memory_resource());
+	AllocationScope allocations;
+	{
+		MultiErr<std::size_t, 4> errors(&arena);
+		for (std::size_t i = 0; i < 100; ++i)
+			errors.push(std::move(i));
+		EXPECT_TRUE(errors.size() == 100 && errors.dropped() == 0);
+		EXPECT_TRUE(errors[3] == 3 && errors[4] == 4 && errors[99] == 99);
+	}
+	EXPECT_TRUE(allocations.allocations() == 0);
+
+	MultiErr<std::string, 1> strings(std::pmr::new_delete_resource());
+	strings.push(std::string("first"));
+	strings.push(std::string("second"));
+	EXPECT_TRUE(strings.size() == 2 && strings[1] == "second");
+	PrintResult("MultiErr spills to an arena:", failures);
+}
+
+Status validate_field(const int& field)
+{
+	if (field < 0) return int{ field };
+	return OwningOk<void>();
+}
+
+void check_MultiErr_validate_all(void)
+{
+	std::size_t failures = failed_checks();
+
+	std::vector<int> fields = { 1, -2, 3, -4, 5, -6 };
+	auto			 status = validate_all<2>(fields, validate_field);
+	EXPECT_TRUE(status.is_err());
+	const MultiErr<int, 2>* errors = status.peek_err();
+	EXPECT_TRUE(errors != nullptr && errors->size() == 2 && errors->dropped() == 1);
+	EXPECT_TRUE((*errors)[0] == -2 && (*errors)[1] == -4);
+
+	std::vector<int> valid = { 1, 2, 3 };
+	EXPECT_ALLOCS(0, EXPECT_TRUE(validate_all<2>(valid, validate_field).is_ok()));
+
+	// A range of already computed results has its errors consumed
+	std::vector<OwningResult<int, int>> results;
+	results.push_back(OwningOk<int>(1));
+	results.push_back(OwningErr<int>(2));
+	results.push_back(OwningErr<int>(3));
+	auto collected = validate_all<4>(results);
+	EXPECT_TRUE(collected.is_err() && collected.peek_err()->size() == 2);
+	EXPECT_TRUE(results[0].is_ok() && results[1].peek_err() == nullptr);
+	PrintResult("validate_all collects every error:", failures);
+}
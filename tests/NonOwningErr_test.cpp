@@ -21,8 +21,9 @@
 //    =================================
 
 #include "Err.hpp"
-#include "test.hpp"
+#include "instrumentation.hpp"
 
+#include <memory>
 #include <string>
 
 void check_NonowningErr_create_for_shared_pointer(void);
@@ -32,28 +33,31 @@ int main()
 {
 	check_NonowningErr_create_for_shared_pointer();
 	check_NonowningErr_for_proper_get();
-	return 0;
+	return test_exit_code();
 }
 
 void check_NonowningErr_create_for_shared_pointer(void)
 {
-	PrintLn("Beginning of pointer function");
-	std::shared_ptr<std::string> vec(new std::string("nonowning ok"));
-	for (auto& x : *vec)
-	{
-		type_name(x);
-		x = 1.0;
-	}
-
-	NonowningErr<std::string> my_ok(vec);
-	COMPILE_TIME_PRINT("\033[01;32mNo error compiling construction of NonowningErr from pointer\033[0m");
-	PrintLn("Construct NonowningErr from pointer: \033[01;32m[Passed]\033[0m");
+	std::size_t failures = failed_checks();
+
+	// Only a weak reference is taken, the shared object is neither copied nor reallocated
+	auto text = std::make_shared<std::string>("nonowning err");
+	EXPECT_ALLOCS(0, NonowningErr<std::string> my_err(text));
+	EXPECT_TRUE(text.use_count() == 1);
+
+	auto tracked = std::make_shared<Tracked>(4);
+	EXPECT_COPIES(0, NonowningErr<Tracked> my_err(tracked));
+	PrintResult("Construct NonowningErr from pointer:", failures);
 }
 
 void check_NonowningErr_for_proper_get(void)
 {
-	std::shared_ptr<int>		n(new int);
-	NonowningErr<int>			my_ok_1(n);
-	[[maybe_unused]] const auto n_ref = my_ok_1.get();
-	PrintLn("NonowningErr does proper get and release: \033[01;32m[Passed]\033[0m");
+	std::size_t failures = failed_checks();
+
+	auto			 n = std::make_shared<int>(5);
+	NonowningErr<int> my_err_1(n);
+	EXPECT_TRUE(&my_err_1.get() == n.get());
+	EXPECT_ALLOCS(0, my_err_1.get() = 6);
+	EXPECT_TRUE(*n == 6);
+	PrintResult("NonowningErr does proper get:", failures);
 }
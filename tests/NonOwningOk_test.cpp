@@ -21,8 +21,9 @@
 //    =================================
 
 #include "Ok.hpp"
-#include "test.hpp"
+#include "instrumentation.hpp"
 
+#include <memory>
 #include <string>
 
 void check_NonowningOk_create_for_shared_pointer(void);
@@ -32,28 +33,31 @@ int main()
 {
 	check_NonowningOk_create_for_shared_pointer();
 	check_NonowningOk_for_proper_get();
-	return 0;
+	return test_exit_code();
 }
 
 void check_NonowningOk_create_for_shared_pointer(void)
 {
-	PrintLn("Beginning of pointer function");
-	std::shared_ptr<std::string> vec(new std::string("nonowning ok"));
-	for (auto& x : *vec)
-	{
-		type_name(x);
-		x = 1.0;
-	}
-
-	NonowningOk<std::string> my_ok(vec);
-	COMPILE_TIME_PRINT("\033[01;32mNo error compiling construction of NonowningOk from pointer\033[0m");
-	PrintLn("Construct NonowningOk from pointer: \033[01;32m[Passed]\033[0m");
+	std::size_t failures = failed_checks();
+
+	// Only a weak reference is taken, the shared object is neither copied nor reallocated
+	auto text = std::make_shared<std::string>("nonowning ok");
+	EXPECT_ALLOCS(0, NonowningOk<std::string> my_ok(text));
+	EXPECT_TRUE(text.use_count() == 1);
+
+	auto tracked = std::make_shared<Tracked>(4);
+	EXPECT_COPIES(0, NonowningOk<Tracked> my_ok(tracked));
+	PrintResult("Construct NonowningOk from pointer:", failures);
 }
 
 void check_NonowningOk_for_proper_get(void)
 {
-	std::shared_ptr<int>		n(new int);
-	NonowningOk<int>			my_ok_1(n);
-	[[maybe_unused]] const auto n_ref = my_ok_1.get();
-	PrintLn("NonowningOk does proper get and release: \033[01;32m[Passed]\033[0m");
+	std::size_t failures = failed_checks();
+
+	auto			 n = std::make_shared<int>(5);
+	NonowningOk<int> my_ok_1(n);
+	EXPECT_TRUE(&my_ok_1.get() == n.get());
+	EXPECT_ALLOCS(0, my_ok_1.get() = 6);
+	EXPECT_TRUE(*n == 6);
+	PrintResult("NonowningOk does proper get:", failures);
 }
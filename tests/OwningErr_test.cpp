@@ -20,9 +20,9 @@
 //    =================================
 
 #include "Err.hpp"
-#include "test.hpp"
+#include "instrumentation.hpp"
 
-#include <vector>
+#include <string>
 
 void check_OwningErr_create_for_value(void);
 void check_OwningErr_create_for_pointer(void);
@@ -33,38 +33,57 @@ int main()
 	check_OwningErr_create_for_value();
 	check_OwningErr_create_for_pointer();
 	check_OwningErr_for_proper_get_and_release();
-	return 0;
+	return test_exit_code();
 }
 
 void check_OwningErr_create_for_value(void)
 {
-	std::string vec("owning ok");
-	for (auto& x : vec)
-		x = 1.0;
+	std::size_t failures = failed_checks();
 
-	OwningErr<std::string> my_ok(std::move(vec));
-	COMPILE_TIME_PRINT("\033[01;32mNo error compiling construction of OwningErr from value\033[0m")
-	PrintLn("Construct OwningErr from value: \033[01;32m[Passed]\033[0m");
-	PrintLn("End of value function");
+	// One box for the value, which is moved into it and never copied
+	EXPECT_ALLOCS_BALANCED(1, OwningErr<Tracked> my_err(Tracked(1)));
+	EXPECT_COPIES(0, OwningErr<Tracked> my_err(Tracked(1)));
+	EXPECT_MOVES(1, OwningErr<Tracked> my_err(Tracked(1)));
+
+	TrackedScope		 scope;
+	{
+		OwningErr<Tracked> my_err(Tracked(2));
+		EXPECT_TRUE(my_err.peek() != nullptr && my_err.peek()->value() == 2);
+	}
+	EXPECT_TRUE(scope.alive() == 0);
+
+	std::string text("owning err");
+	OwningErr<std::string> my_string(std::move(text));
+	EXPECT_TRUE(my_string.get() == "owning err");
+	PrintResult("Construct OwningErr from value:", failures);
 }
 
 void check_OwningErr_create_for_pointer(void)
 {
-	PrintLn("Beginning of pointer function");
-	std::string* vec = new std::string("owning ok");
-	for (auto& x : *vec)
-		x = 1.0;
+	std::size_t failures = failed_checks();
+
+	// Ownership of the pointee is taken over, nothing is allocated
+	std::string* text = new std::string("owning err");
+	EXPECT_ALLOCS(0, OwningErr<std::string*> my_err(std::move(text)));
+	EXPECT_TRUE(text == nullptr);
 
-	OwningErr<std::string*> my_ok(std::move(vec));
-	COMPILE_TIME_PRINT("\033[01;32mNo error compiling construction of OwningErr from pointer\033[0m");
-	PrintLn("Construct OwningErr from pointer: \033[01;32m[Passed]\033[0m");
+	Tracked* tracked = new Tracked(3);
+	EXPECT_COPIES(0, OwningErr<Tracked*> my_err(std::move(tracked)));
+	PrintResult("Construct OwningErr from pointer:", failures);
 }
 
 void check_OwningErr_for_proper_get_and_release(void)
 {
-	int							n = 10;
-	OwningErr<int>				my_ok_1(std::move(n));
-	[[maybe_unused]] const auto n_ref = my_ok_1.get();
-	[[maybe_unused]] int*		n_ptr = my_ok_1.release();
-	PrintLn("OwningErr does proper get and release: \033[01;32m[Passed]\033[0m");
+	std::size_t failures = failed_checks();
+
+	OwningErr<int> my_err_1(10);
+	EXPECT_ALLOCS(0, my_err_1.get() = 11);
+	EXPECT_TRUE(my_err_1.peek() != nullptr && *my_err_1.peek() == 11);
+
+	int* n_ptr = nullptr;
+	EXPECT_ALLOCS(0, n_ptr = my_err_1.release());
+	EXPECT_TRUE(n_ptr != nullptr && *n_ptr == 11);
+	EXPECT_TRUE(my_err_1.peek() == nullptr);
+	delete n_ptr;
+	PrintResult("OwningErr does proper get and release:", failures);
 }
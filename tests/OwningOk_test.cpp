@@ -20,9 +20,9 @@
 //    =================================
 
 #include "Ok.hpp"
-#include "test.hpp"
+#include "instrumentation.hpp"
 
-#include <vector>
+#include <string>
 
 void check_OwningOk_create_for_value(void);
 void check_OwningOk_create_for_pointer(void);
@@ -33,38 +33,57 @@ int main()
 	check_OwningOk_create_for_value();
 	check_OwningOk_create_for_pointer();
 	check_OwningOk_for_proper_get_and_release();
-	return 0;
+	return test_exit_code();
 }
 
 void check_OwningOk_create_for_value(void)
 {
-	std::string vec("owning ok");
-	for (auto& x : vec)
-		x = 1.0;
+	std::size_t failures = failed_checks();
 
-	OwningOk<std::string> my_ok(std::move(vec));
-	COMPILE_TIME_PRINT("\033[01;32mNo error compiling construction of OwningOk from value\033[0m")
-	PrintLn("Construct OwningOk from value: \033[01;32m[Passed]\033[0m");
-	PrintLn("End of value function");
+	// One box for the value, which is moved into it and never copied
+	EXPECT_ALLOCS_BALANCED(1, OwningOk<Tracked> my_ok(Tracked(1)));
+	EXPECT_COPIES(0, OwningOk<Tracked> my_ok(Tracked(1)));
+	EXPECT_MOVES(1, OwningOk<Tracked> my_ok(Tracked(1)));
+
+	TrackedScope		 scope;
+	{
+		OwningOk<Tracked> my_ok(Tracked(2));
+		EXPECT_TRUE(my_ok.peek() != nullptr && my_ok.peek()->value() == 2);
+	}
+	EXPECT_TRUE(scope.alive() == 0);
+
+	std::string text("owning ok");
+	OwningOk<std::string> my_string(std::move(text));
+	EXPECT_TRUE(my_string.get() == "owning ok");
+	PrintResult("Construct OwningOk from value:", failures);
 }
 
 void check_OwningOk_create_for_pointer(void)
 {
-	PrintLn("Beginning of pointer function");
-	std::string* vec = new std::string("owning ok");
-	for (auto& x : *vec)
-		x = 1.0;
+	std::size_t failures = failed_checks();
+
+	// Ownership of the pointee is taken over, nothing is allocated
+	std::string* text = new std::string("owning ok");
+	EXPECT_ALLOCS(0, OwningOk<std::string*> my_ok(std::move(text)));
+	EXPECT_TRUE(text == nullptr);
 
-	OwningOk<std::string*> my_ok(std::move(vec));
-	COMPILE_TIME_PRINT("\033[01;32mNo error compiling construction of OwningOk from pointer\033[0m");
-	PrintLn("Construct OwningOk from pointer: \033[01;32m[Passed]\033[0m");
+	Tracked* tracked = new Tracked(3);
+	EXPECT_COPIES(0, OwningOk<Tracked*> my_ok(std::move(tracked)));
+	PrintResult("Construct OwningOk from pointer:", failures);
 }
 
 void check_OwningOk_for_proper_get_and_release(void)
 {
-	int							n = 10;
-	OwningOk<int>				my_ok_1(std::move(n));
-	[[maybe_unused]] const auto n_ref = my_ok_1.get();
-	[[maybe_unused]] int*		n_ptr = my_ok_1.release();
-	PrintLn("OwningOk does proper get and release: \033[01;32m[Passed]\033[0m");
+	std::size_t failures = failed_checks();
+
+	OwningOk<int> my_ok_1(10);
+	EXPECT_ALLOCS(0, my_ok_1.get() = 11);
+	EXPECT_TRUE(my_ok_1.peek() != nullptr && *my_ok_1.peek() == 11);
+
+	int* n_ptr = nullptr;
+	EXPECT_ALLOCS(0, n_ptr = my_ok_1.release());
+	EXPECT_TRUE(n_ptr != nullptr && *n_ptr == 11);
+	EXPECT_TRUE(my_ok_1.peek() == nullptr);
+	delete n_ptr;
+	PrintResult("OwningOk does proper get and release:", failures);
 }
@@ -0,0 +1,232 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    =================================
+//    Author: Kevin Ingles
+//    File: OwningResult_test.cpp
+//    Description: Allocation, copy and move guarantees of OwningResult
+//    =================================
+
+#include "Result.hpp"
+#include "instrumentation.hpp"
+
+#include <cstdint>
+
+using TrackedResult = OwningResult<Tracked, int>;
+using IntResult		= OwningResult<int, int>;
+
+void check_OwningResult_construct(void);
+void check_OwningResult_unwrap(void);
+void check_OwningResult_map(void);
+void check_OwningResult_peek(void);
+void check_OwningResult_likelihood(void);
+void check_OwningResult_void(void);
+
+int main()
+{
+	check_OwningResult_construct();
+	check_OwningResult_unwrap();
+	check_OwningResult_map();
+	check_OwningResult_peek();
+	check_OwningResult_likelihood();
+	check_OwningResult_void();
+	return test_exit_code();
+}
+
+void check_OwningResult_construct(void)
+{
+	std::size_t failures = failed_checks();
+
+	// Ok and Err each own a single heap allocation, the other side is left empty
+	EXPECT_ALLOCS_BALANCED(1, TrackedResult result = OwningOk<Tracked>(Tracked(1)));
+	EXPECT_ALLOCS_BALANCED(1, TrackedResult result = OwningErr<int>(1));
+	EXPECT_COPIES(0, TrackedResult result = OwningOk<Tracked>(Tracked(1)));
+	EXPECT_MOVES(1, TrackedResult result = OwningOk<Tracked>(Tracked(1)));
+
+	// Moving the result around moves the box, not the payload
+	TrackedResult first = OwningOk<Tracked>(Tracked(2));
+	EXPECT_ALLOCS(0, TrackedResult second(std::move(first)));
+	TrackedResult second = OwningOk<Tracked>(Tracked(2));
+	EXPECT_MOVES(0, TrackedResult third(std::move(second)));
+	PrintResult("Construct OwningResult:", failures);
+}
+
+void check_OwningResult_unwrap(void)
+{
+	std::size_t failures = failed_checks();
+
+	// The value is moved out of the box exactly once and the box is freed
+	TrackedResult result = OwningOk<Tracked>(Tracked(3));
+	AllocationScope allocations;
+	TrackedScope	tracked;
+	Tracked			value = result.unwrap();
+	EXPECT_TRUE(allocations.allocations() == 0);
+	EXPECT_TRUE(allocations.deallocations() == 1);
+	EXPECT_TRUE(tracked.copies() == 0);
+	EXPECT_TRUE(tracked.moves() == 1);
+	EXPECT_TRUE(value.value() == 3);
+	EXPECT_TRUE(result.peek_ok() == nullptr);
+
+	TrackedResult other = OwningOk<Tracked>(Tracked(4));
+	EXPECT_ALLOCS(0, (void)other.expect("holds a value"));
+
+	IntResult err = OwningErr<int>(5);
+	EXPECT_ALLOCS(0, (void)err.err());
+	PrintResult("Unwrap OwningResult:", failures);
+}
+
+void check_OwningResult_map(void)
+{
+	std::size_t failures = failed_checks();
+
+	// map makes one allocation for the new Ok box and leaves the value in place
+	IntResult ok = OwningOk<int>(6);
+	EXPECT_ALLOCS(1, IntResult mapped = ok.map<int>([](int& n) { return n * 2; }));
+
+	IntResult doubled = OwningOk<int>(7);
+	IntResult mapped  = doubled.map<int>([](int& n) { return n * 2; });
+	EXPECT_TRUE(mapped.is_ok() && mapped.unwrap() == 14);
+
+	// The error box is handed over without allocating
+	IntResult err = OwningErr<int>(8);
+	EXPECT_ALLOCS(0, IntResult untouched = err.map<int>([](int& n) { return n * 2; }));
+
+	IntResult failed	 = OwningErr<int>(9);
+	IntResult mapped_err = failed.map_err<int>([](int& n) { return n + 1; });
+	EXPECT_TRUE(mapped_err.is_err() && *mapped_err.err() == 10);
+
+	TrackedResult tracked = OwningOk<Tracked>(Tracked(10));
+	EXPECT_COPIES(0, IntResult values = tracked.map<int>([](Tracked& t) { return t.value(); }));
+	PrintResult("Map OwningResult:", failures);
+}
+
+void check_OwningResult_peek(void)
+{
+	std::size_t failures = failed_checks();
+
+	TrackedResult result = OwningOk<Tracked>(Tracked(11));
+	EXPECT_ALLOCS(0, EXPECT_TRUE(result.peek_ok() != nullptr && result.peek_ok()->value() == 11));
+	EXPECT_COPIES(0, EXPECT_TRUE(result.is_ok() && result.peek_err() == nullptr));
+	PrintResult("Peek into OwningResult:", failures);
+}
+
+// The likelihood policy only changes code layout, never behaviour or cost
+template<typename Policy>
+void check_likelihood_policy(void)
+{
+	using Result = OwningResult<int, int, Policy>;
+
+	Result ok  = OwningOk<int>(1);
+	Result err = OwningErr<int>(2);
+	EXPECT_TRUE(ok.is_ok() && !ok.is_err() && err.is_err() && !err.is_ok());
+	EXPECT_TRUE(ok.is_ok_and([](int& n) { return n == 1; }));
+	EXPECT_TRUE(err.is_err_and([](int& n) { return n == 2; }));
+	EXPECT_TRUE(ok.template map_or<int>(0, [](int& n) { return n + 1; }) == 2);
+	EXPECT_TRUE(err.template map_or<int>(0, [](int& n) { return n + 1; }) == 0);
+
+	EXPECT_ALLOCS(1, Result mapped = ok.template map<int>([](int& n) { return n * 3; }));
+	EXPECT_ALLOCS(0, Result mapped = err.template map<int>([](int& n) { return n * 3; }));
+}
+
+void check_OwningResult_likelihood(void)
+{
+	std::size_t failures = failed_checks();
+	static_assert(std::is_same_v<IntResult::likelihood_policy, OkLikely>);
+	check_likelihood_policy<OkLikely>();
+	check_likelihood_policy<ErrLikely>();
+	check_likelihood_policy<Neutral>();
+	PrintResult("OwningResult likelihood policies agree:", failures);
+}
+
+enum class ErrCode : std::uint32_t
+{
+	timeout = 1,
+	refused
+};
+
+struct Empty {
+};
+
+// Empty, but there is no value to make up for the side that is not set
+struct EmptyWithoutDefault {
+	explicit EmptyWithoutDefault(int) {}
+};
+
+struct CodeAndTag {
+	ErrCode		 code;
+	std::uint8_t tag;
+};
+
+// Status-only results are the error code plus a one byte tag, nothing is boxed
+static_assert(sizeof(OwningResult<void, ErrCode>) == sizeof(CodeAndTag));
+static_assert(sizeof(OwningResult<void, std::uint64_t>) == 2 * sizeof(std::uint64_t));
+static_assert(sizeof(OwningResult<ErrCode, void>) == sizeof(CodeAndTag));
+static_assert(sizeof(OwningResult<void, Empty>) == 1);
+static_assert(sizeof(OwningResult<Empty, void>) == 1);
+static_assert(std::is_empty_v<OwningOk<Empty>> && std::is_empty_v<OwningErr<Empty>>);
+static_assert(sizeof(OwningResult<Empty, Empty>) < sizeof(void*));
+static_assert(sizeof(OwningResult<Empty, int*>) < sizeof(OwningResult<int*, int*>));
+template<typename Owning>
+concept hands_out_pointer = requires(Owning& owning) { owning.release(); };
+static_assert(!hands_out_pointer<OwningOk<Empty>> && !hands_out_pointer<OwningErr<Empty>>);
+static_assert(sizeof(OwningOk<EmptyWithoutDefault>) == sizeof(void*));
+
+void check_OwningResult_void(void)
+{
+	std::size_t failures = failed_checks();
+	using Status		 = OwningResult<void, ErrCode>;
+	using Maybe			 = OwningResult<Tracked, void>;
+
+	EXPECT_ALLOCS(0, Status status = OwningOk<void>());
+	EXPECT_ALLOCS(0, Status status = ErrCode::timeout);
+	EXPECT_ALLOCS(0, Status status = ErrCode::timeout; (void)status.err());
+
+	Status success = OwningOk<void>();
+	Status failure = ErrCode::refused;
+	EXPECT_TRUE(success.is_ok() && failure.is_err());
+	EXPECT_TRUE(failure.peek_err() != nullptr && *failure.peek_err() == ErrCode::refused);
+	EXPECT_TRUE(failure.is_err_and([](ErrCode& code) { return code == ErrCode::refused; }));
+	EXPECT_TRUE(*failure.err() == ErrCode::refused && failure.peek_err() == nullptr);
+	success.unwrap();
+
+	Status renamed = ErrCode::timeout;
+	auto   code	   = renamed.map_err<int>([](ErrCode& c) { return static_cast<int>(c); });
+	EXPECT_TRUE(*code.err() == 1);
+
+	// The value lives inline, it is moved in and out exactly once each
+	EXPECT_ALLOCS(0, Maybe maybe = Tracked(1));
+	EXPECT_MOVES(1, Maybe maybe = Tracked(1));
+	Maybe some = Tracked(2);
+	Maybe none = OwningErr<void>();
+	EXPECT_TRUE(some.is_ok() && none.is_err() && none.peek_ok() == nullptr);
+	EXPECT_MOVES(1, Tracked value = some.unwrap(); EXPECT_TRUE(value.value() == 2));
+	EXPECT_TRUE(some.peek_ok() == nullptr);
+
+	// Empty payloads are kept inline even by the general OwningResult
+	using EmptyResult = OwningResult<Empty, Empty>;
+	EXPECT_ALLOCS(0, EmptyResult empty = OwningOk<Empty>(Empty{}); (void)empty.unwrap());
+
+	// Empty types without a default constructor are boxed instead, one allocation per side
+	using BoxedEmpty = OwningResult<EmptyWithoutDefault, EmptyWithoutDefault>;
+	using BoxedOk	 = OwningOk<EmptyWithoutDefault>;
+	using BoxedErr	 = OwningErr<EmptyWithoutDefault>;
+	EXPECT_ALLOCS_BALANCED(2, BoxedEmpty boxed_ok = BoxedOk(EmptyWithoutDefault(1));
+						   BoxedEmpty boxed_err = BoxedErr(EmptyWithoutDefault(2));
+						   EXPECT_TRUE(boxed_ok.peek_err() == nullptr);
+						   EXPECT_TRUE(boxed_err.peek_ok() == nullptr);
+						   (void)boxed_ok.unwrap(); (void)boxed_err.err());
+	PrintResult("OwningResult void and empty specializations:", failures);
+}
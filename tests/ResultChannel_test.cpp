@@ -0,0 +1,231 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: ResultChannel_test.cpp
+//    Description: Checks ordering, batching and the close-on-error policy of the result channels
+//    =================================
+
+#include "ResultChannel.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+void check_SpscResultChannel_preserves_order(void);
+void check_MpmcResultChannel_delivers_everything_once(void);
+void check_ResultChannel_batch_push_and_pop(void);
+void check_ResultChannel_closes_on_first_err(void);
+void check_MpmcResultChannel_drains_everything_after_err(void);
+
+int main()
+{
+	check_SpscResultChannel_preserves_order();
+	check_MpmcResultChannel_delivers_everything_once();
+	check_ResultChannel_batch_push_and_pop();
+	check_ResultChannel_closes_on_first_err();
+	check_MpmcResultChannel_drains_everything_after_err();
+	return test_exit_code();
+}
+
+void check_SpscResultChannel_preserves_order(void)
+{
+	std::size_t failures = failed_checks();
+
+	constexpr int				count = 10000;
+	SpscResultChannel<int, int> channel(16);
+
+	std::thread producer([&channel]() {
+		for (int i = 0; i < count; ++i)
+			channel.push(OwningOk<int>(int{ i }));
+		channel.close();
+	});
+
+	int expected = 0;
+	while (auto result = channel.pop())
+	{
+		EXPECT_TRUE(result->unwrap() == expected);
+		++expected;
+	}
+	producer.join();
+	EXPECT_TRUE(expected == count);
+	PrintResult("SpscResultChannel preserves order:", failures);
+}
+
+void check_MpmcResultChannel_delivers_everything_once(void)
+{
+	std::size_t failures = failed_checks();
+
+	constexpr int				num_producers = 3;
+	constexpr int				per_producer  = 5000;
+	MpmcResultChannel<int, int> channel(64);
+	std::atomic<long>			sum{ 0 };
+	std::atomic<int>			received{ 0 };
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < num_producers; ++p)
+		threads.emplace_back([&channel]() {
+			for (int i = 1; i <= per_producer; ++i)
+				channel.push(OwningOk<int>(int{ i }));
+		});
+	std::vector<std::thread> consumers;
+	for (int c = 0; c < 2; ++c)
+		consumers.emplace_back([&]() {
+			while (auto result = channel.pop())
+			{
+				sum += result->unwrap();
+				++received;
+			}
+		});
+
+	for (auto& thread : threads)
+		thread.join();
+	channel.close();
+	for (auto& thread : consumers)
+		thread.join();
+
+	EXPECT_TRUE(received == num_producers * per_producer);
+	EXPECT_TRUE(sum == num_producers * per_producer * (per_producer + 1) / 2);
+	PrintResult("MpmcResultChannel delivers everything once:", failures);
+}
+
+void check_ResultChannel_batch_push_and_pop(void)
+{
+	std::size_t failures = failed_checks();
+
+	SpscResultChannel<int, int> spsc(8);
+	MpmcResultChannel<int, int> mpmc(8);
+
+	std::vector<OwningResult<int, int>> batch;
+	for (int i = 0; i < 12; ++i)
+		batch.push_back(OwningOk<int>(int{ i }));
+	EXPECT_TRUE(spsc.push_n(std::span(batch)) == 8);
+
+	std::vector<OwningResult<int, int>> out;
+	EXPECT_TRUE(spsc.pop_n(out, 5) == 5 && out.size() == 5);
+	EXPECT_TRUE(spsc.push_n(std::span(batch).subspan(8)) == 4);
+	EXPECT_TRUE(spsc.pop_n(out, 100) == 7);
+	for (int i = 0; i < 12; ++i)
+		EXPECT_TRUE(out[static_cast<std::size_t>(i)].unwrap() == i);
+
+	batch.clear();
+	for (int i = 0; i < 12; ++i)
+		batch.push_back(OwningOk<int>(int{ i }));
+	EXPECT_TRUE(mpmc.push_n(std::span(batch)) == 8);
+	out.clear();
+	EXPECT_TRUE(mpmc.pop_n(out, 100) == 8);
+	for (int i = 0; i < 8; ++i)
+		EXPECT_TRUE(out[static_cast<std::size_t>(i)].unwrap() == i);
+	PrintResult("ResultChannel batch push and pop:", failures);
+}
+
+void check_ResultChannel_closes_on_first_err(void)
+{
+	std::size_t failures = failed_checks();
+
+	SpscResultChannel<int, int, ChannelPolicy::CloseOnErr> channel(8);
+	EXPECT_TRUE(channel.push(OwningOk<int>(1)));
+	EXPECT_TRUE(channel.push(OwningErr<int>(-1)));
+	EXPECT_TRUE(channel.is_closed());
+	EXPECT_TRUE(!channel.push(OwningOk<int>(2)));
+
+	auto first = channel.pop();
+	EXPECT_TRUE(first && first->unwrap() == 1);
+	auto error = channel.pop();
+	EXPECT_TRUE(error && error->is_err() && error->err() == -1);
+	EXPECT_TRUE(!channel.pop());
+
+	MpmcResultChannel<int, int, ChannelPolicy::CloseOnErr> mpmc(8);
+	std::vector<OwningResult<int, int>>					   batch;
+	batch.push_back(OwningOk<int>(1));
+	batch.push_back(OwningErr<int>(-1));
+	batch.push_back(OwningOk<int>(2));
+	EXPECT_TRUE(mpmc.push_n(std::span(batch)) == 2);
+	PrintResult("ResultChannel closes on first error:", failures);
+}
+
+void check_MpmcResultChannel_drains_everything_after_err(void)
+{
+	std::size_t failures = failed_checks();
+
+	// Moving a flagged value into a cell stalls the producer after it claimed the cell and
+	// before it published it, the error is only pushed once every other producer sits there
+	static thread_local bool stall = false;
+	static std::atomic<int>	 stalled{ 0 };
+	struct SlowMove {
+		SlowMove(void) = default;
+		SlowMove(SlowMove&&) noexcept
+		{
+			if (!stall) return;
+			stalled.fetch_add(1, std::memory_order_release);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	};
+	using SlowResult = OwningResult<SlowMove, int>;
+
+	constexpr int rounds		= 100;
+	constexpr int num_producers = 4;
+	constexpr int num_consumers = 2;
+	constexpr int per_producer	= 200;
+
+	for (int round = 0; round < rounds; ++round)
+	{
+		MpmcResultChannel<SlowMove, int, ChannelPolicy::CloseOnErr> channel(8);
+		std::atomic<int>											pushed{ 0 };
+		std::atomic<int>											popped{ 0 };
+		std::atomic<int>											errors{ 0 };
+		const int													fail_at = round;
+		stalled.store(0);
+
+		std::vector<std::thread> threads;
+		for (int p = 0; p < num_producers; ++p)
+			threads.emplace_back([&channel, &pushed, p, fail_at]() {
+				for (int i = 0; i < per_producer; ++i)
+				{
+					if (p == 0 && i == fail_at)
+					{
+						while (stalled.load(std::memory_order_acquire) < num_producers - 1)
+							std::this_thread::yield();
+						channel.push(SlowResult(OwningErr<int>(-1)));
+						pushed.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+					SlowResult result(OwningOk<SlowMove>(SlowMove{}));
+					stall	  = i == fail_at;
+					bool done = !channel.push(std::move(result));
+					stall	  = false;
+					if (done) return;
+					pushed.fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+		for (int c = 0; c < num_consumers; ++c)
+			threads.emplace_back([&channel, &popped, &errors]() {
+				while (auto result = channel.pop())
+				{
+					popped.fetch_add(1, std::memory_order_relaxed);
+					if (result->is_err()) errors.fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+		for (auto& thread : threads)
+			thread.join();
+
+		EXPECT_TRUE(popped.load() == pushed.load());
+		EXPECT_TRUE(errors.load() == 1);
+	}
+	PrintResult("MpmcResultChannel drains everything pushed before closing:", failures);
+}
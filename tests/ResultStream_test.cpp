@@ -0,0 +1,161 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: ResultStream_test.cpp
+//    Description: Checks that ResultStream is lazy, reuses the producer's buffer and applies its
+//                 error policy
+//    =================================
+
+#include "ResultStream.hpp"
+#include "instrumentation.hpp"
+
+#include <ranges>
+#include <stdexcept>
+#include <string>
+
+static_assert(std::ranges::input_range<ResultStream<int, int>>);
+static_assert(std::ranges::input_range<ResultStream<std::string, int, CollectErrors<4>>>);
+
+void check_ResultStream_lazy_reuse(void);
+void check_ResultStream_policies(void);
+void check_ResultStream_exception(void);
+
+int main()
+{
+	check_ResultStream_lazy_reuse();
+	check_ResultStream_policies();
+	check_ResultStream_exception();
+	return test_exit_code();
+}
+
+// Yields `count` records of 40 characters from one buffer, counting how many were produced
+ResultStream<std::string, int> numbered_lines(int count, int& produced)
+{
+	std::string line;
+	for (int i = 0; i < count; ++i)
+	{
+		line.assign(40, static_cast<char>('a' + i % 26));
+		++produced;
+		co_yield line;
+	}
+}
+
+// Every `every`-th record fails with its index as the error
+template<typename Policy>
+ResultStream<int, std::string, Policy> every_nth_fails(int count, int every)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (i % every == every - 1) co_yield OwningErr<std::string>(std::to_string(i));
+		else co_yield i;
+	}
+}
+
+void check_ResultStream_lazy_reuse(void)
+{
+	std::size_t failures = failed_checks();
+
+	// Nothing runs until begin, and the producer never gets ahead of the consumer
+	int	 produced = 0;
+	auto stream	  = numbered_lines(1000, produced);
+	EXPECT_TRUE(produced == 0);
+	auto it = stream.begin();
+	EXPECT_TRUE(produced == 1 && (*it).is_ok() && (*it).unwrap() == std::string(40, 'a'));
+	++it;
+	EXPECT_TRUE(produced == 2 && (*it).unwrap().front() == 'b');
+
+	// Every record borrows the same buffer, so steady state iteration does not allocate
+	const std::string* buffer = (*it).peek_ok();
+	bool			   reused = true;
+	std::size_t		   count  = 2;
+	AllocationScope	   allocations;
+	for (++it; it != std::default_sentinel; ++it, ++count)
+		reused = reused && (*it).peek_ok() == buffer;
+	EXPECT_TRUE(allocations.allocations() == 0);
+	EXPECT_TRUE(reused && count == 1000 && produced == 1000);
+
+	// Abandoning a stream halfway destroys the coroutine frame and the buffer it owned
+	EXPECT_ALLOCS_BALANCED(2, {
+		int	 started = 0;
+		auto partial = numbered_lines(10, started);
+		for (auto record : partial)
+			if (record.unwrap().front() == 'c') break;
+	});
+	PrintResult("ResultStream is lazy and borrows the producer's buffer:", failures);
+}
+
+void check_ResultStream_policies(void)
+{
+	std::size_t failures = failed_checks();
+
+	// Stop hands out the first error, then ends
+	auto stop	 = every_nth_fails<StopOnError>(10, 3);
+	int	 ok		 = 0;
+	int	 errors	 = 0;
+	for (auto record : stop)
+	{
+		if (record.is_ok()) ++ok;
+		else errors += *record.peek_err() == "2";
+	}
+	EXPECT_TRUE(ok == 2 && errors == 1);
+
+	// Skip only hands out Ok records and counts the rest
+	auto skip = every_nth_fails<SkipErrors>(10, 3);
+	int	 sum  = 0;
+	for (auto record : skip)
+		sum += record.unwrap();
+	EXPECT_TRUE(sum == 0 + 1 + 3 + 4 + 6 + 7 + 9 && skip.skipped() == 3);
+
+	// Collect keeps the first N errors and counts the others
+	auto collect = every_nth_fails<CollectErrors<2>>(10, 3);
+	ok			 = 0;
+	for (auto record : collect)
+		ok += record.is_ok();
+	EXPECT_TRUE(ok == 7 && collect.errors().size() == 2 && collect.errors().dropped() == 1);
+	EXPECT_TRUE(collect.errors()[0] == "2" && collect.errors()[1] == "5");
+	auto taken = collect.take_errors();
+	EXPECT_TRUE(taken.size() == 2 && collect.errors().empty());
+	PrintResult("ResultStream stops on, skips or collects errors:", failures);
+}
+
+ResultStream<int, int> throws_after(int count)
+{
+	for (int i = 0; i < count; ++i)
+		co_yield i;
+	throw std::runtime_error("producer failed");
+}
+
+void check_ResultStream_exception(void)
+{
+	std::size_t failures = failed_checks();
+
+	auto		stream = throws_after(2);
+	int			seen   = 0;
+	std::string message;
+	try
+	{
+		for (auto record : stream)
+			seen += record.is_ok();
+	}
+	catch (const std::runtime_error& exception)
+	{
+		message = exception.what();
+	}
+	EXPECT_TRUE(seen == 2 && message == "producer failed");
+	PrintResult("ResultStream rethrows what the producer throws:", failures);
+}
@@ -0,0 +1,177 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Serialize_test.cpp
+//    Description: Round trips OwningResult through the binary encoding in Serialize.hpp
+//    =================================
+
+#include "Serialize.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+void check_Serialize_round_trip_trivial_payloads(void);
+void check_Serialize_round_trip_custom_codec(void);
+void check_Serialize_round_trip_batch(void);
+void check_Serialize_rejects_corrupted_buffers(void);
+
+struct Point {
+	double		  x;
+	double		  y;
+	std::uint32_t id;
+};
+
+struct alignas(64) CacheLine {
+	std::uint64_t words[8];
+};
+
+enum class ParseError : std::uint16_t {
+	Empty,
+	Malformed
+};
+
+int main()
+{
+	check_Serialize_round_trip_trivial_payloads();
+	check_Serialize_round_trip_custom_codec();
+	check_Serialize_round_trip_batch();
+	check_Serialize_rejects_corrupted_buffers();
+	return test_exit_code();
+}
+
+void check_Serialize_round_trip_trivial_payloads(void)
+{
+	std::size_t failures = failed_checks();
+
+	OwningResult<Point, ParseError> ok	= OwningOk<Point>(Point{ 1.5, -2.0, 7 });
+	OwningResult<Point, ParseError> err = OwningErr<ParseError>(ParseError::Malformed);
+
+	std::vector<std::byte> ok_bytes	 = encode_result(ok);
+	std::vector<std::byte> err_bytes = encode_result(err);
+	EXPECT_TRUE(ok.is_ok() && ok.peek_ok() != nullptr);
+
+	auto ok_view = ResultView<Point, ParseError>::from_bytes(ok_bytes).unwrap();
+	EXPECT_TRUE(ok_view.is_ok());
+	const Point& in_place = ok_view.ok_ref();
+	const auto*	 address  = reinterpret_cast<const std::byte*>(&in_place);
+	EXPECT_TRUE(address > ok_bytes.data() && address < ok_bytes.data() + ok_bytes.size());
+	EXPECT_TRUE(in_place.x == 1.5 && in_place.y == -2.0 && in_place.id == 7);
+
+	auto err_view = ResultView<Point, ParseError>::from_bytes(err_bytes).unwrap();
+	EXPECT_TRUE(err_view.is_err() && err_view.err_ref() == ParseError::Malformed);
+	EXPECT_TRUE(err_view.to_owned().err() == ParseError::Malformed);
+	PrintResult("Serialize round trips trivially copyable payloads:", failures);
+}
+
+struct Name {
+	std::string first;
+	std::string last;
+};
+
+// User provided codec for a non-trivial payload: "first\0last"
+template<>
+struct ResultCodec<Name> {
+	static constexpr bool		 in_place  = false;
+	static constexpr std::size_t alignment = 1;
+
+	static std::size_t size(const Name& name) { return name.first.size() + 1 + name.last.size(); }
+
+	static void encode(const Name& name, std::byte* out)
+	{
+		std::memcpy(out, name.first.data(), name.first.size());
+		out[name.first.size()] = std::byte{ 0 };
+		std::memcpy(out + name.first.size() + 1, name.last.data(), name.last.size());
+	}
+
+	static Name decode(std::span<const std::byte> bytes)
+	{
+		std::string joined(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		std::size_t split = joined.find('\0');
+		return Name{ joined.substr(0, split), joined.substr(split + 1) };
+	}
+};
+
+void check_Serialize_round_trip_custom_codec(void)
+{
+	std::size_t failures = failed_checks();
+
+	OwningResult<Name, std::string> ok	= OwningOk<Name>(Name{ "Ada", "Lovelace" });
+	OwningResult<Name, std::string> err = OwningErr<std::string>(std::string("no such user"));
+
+	auto ok_bytes  = encode_result(ok);
+	auto err_bytes = encode_result(err);
+	Name name	   = ResultView<Name, std::string>::from_bytes(ok_bytes).unwrap().decode_ok();
+	EXPECT_TRUE(name.first == "Ada" && name.last == "Lovelace");
+	auto err_view = ResultView<Name, std::string>::from_bytes(err_bytes).unwrap();
+	EXPECT_TRUE(err_view.decode_err() == "no such user");
+	PrintResult("Serialize round trips payloads with a custom codec:", failures);
+}
+
+void check_Serialize_round_trip_batch(void)
+{
+	std::size_t failures = failed_checks();
+
+	std::vector<OwningResult<std::uint64_t, std::string>> results;
+	for (std::uint64_t i = 0; i < 100; ++i)
+	{
+		if (i % 7 == 0) results.push_back(OwningErr<std::string>("bad record " + std::to_string(i)));
+		else results.push_back(OwningOk<std::uint64_t>(i * i));
+	}
+
+	auto bytes = encode_results<std::uint64_t, std::string>(results);
+	auto batch = ResultBatchView<std::uint64_t, std::string>::from_bytes(bytes).unwrap();
+	EXPECT_TRUE(batch.size() == results.size());
+	for (std::uint64_t i = 0; i < 100; ++i)
+	{
+		auto record = batch[i];
+		bool matches = (i % 7 == 0)
+						 ? record.is_err() && record.decode_err() == "bad record " + std::to_string(i)
+						 : record.is_ok() && record.ok_ref() == i * i;
+		EXPECT_TRUE(matches);
+	}
+	PrintResult("Serialize round trips batches of results:", failures);
+}
+
+void check_Serialize_rejects_corrupted_buffers(void)
+{
+	std::size_t failures = failed_checks();
+
+	OwningResult<std::uint64_t, ParseError> ok	  = OwningOk<std::uint64_t>(42);
+	std::vector<std::byte>					bytes = encode_result(ok);
+
+	using View	   = ResultView<std::uint64_t, ParseError>;
+	auto truncated = std::span<const std::byte>(bytes).first(bytes.size() - 1);
+	EXPECT_TRUE(View::from_bytes(truncated).err() == SerializationError::Truncated);
+
+	// Reading with a different payload type must not reinterpret the bytes
+	using NarrowView = ResultView<std::uint32_t, ParseError>;
+	EXPECT_TRUE(NarrowView::from_bytes(bytes).err() == SerializationError::SizeMismatch);
+
+	// A buffer ending between the header and an over-aligned payload
+	using WideView										= ResultView<CacheLine, ParseError>;
+	OwningResult<CacheLine, ParseError> wide			= OwningOk<CacheLine>(CacheLine{});
+	alignas(64) std::byte				wide_bytes[128] = {};
+	EXPECT_TRUE(encode_result(wide, std::span<std::byte>(wide_bytes)) == sizeof(wide_bytes));
+	auto header_only = std::span<const std::byte>(wide_bytes).first(sizeof(ResultRecordHeader));
+	EXPECT_TRUE(WideView::from_bytes(header_only).err() == SerializationError::Truncated);
+
+	bytes[0] = std::byte{ 0 };
+	EXPECT_TRUE(View::from_bytes(bytes).err() == SerializationError::BadMagic);
+	PrintResult("Serialize rejects corrupted buffers:", failures);
+}
@@ -0,0 +1,174 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: ThunkGraph_test.cpp
+//    Description: Checks demand driven, memoized and error short-circuiting evaluation of
+//                 ThunkGraph
+//    =================================
+
+#include "ThunkGraph.hpp"
+#include "instrumentation.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+void check_ThunkGraph_evaluates_only_demanded_nodes(void);
+void check_ThunkGraph_memoizes_results(void);
+void check_ThunkGraph_stops_dependents_of_errors(void);
+void check_ThunkGraph_rethrows_exceptions_of_thunks(void);
+
+using Graph = ThunkGraph<int, std::string>;
+
+int main()
+{
+	check_ThunkGraph_evaluates_only_demanded_nodes();
+	check_ThunkGraph_memoizes_results();
+	check_ThunkGraph_stops_dependents_of_errors();
+	check_ThunkGraph_rethrows_exceptions_of_thunks();
+	return test_exit_code();
+}
+
+Graph::ThunkFunction counted_constant(int value, std::atomic<int>& calls)
+{
+	return [value, &calls](Graph::ThunkInputs) -> OwningResult<int, std::string> {
+		++calls;
+		return OwningOk<int>(int{ value });
+	};
+}
+
+Graph::ThunkFunction counted_sum(std::atomic<int>& calls)
+{
+	return [&calls](Graph::ThunkInputs inputs) -> OwningResult<int, std::string> {
+		++calls;
+		int sum = 0;
+		for (const int* input : inputs)
+			sum += *input;
+		return OwningOk<int>(std::move(sum));
+	};
+}
+
+void check_ThunkGraph_evaluates_only_demanded_nodes(void)
+{
+	std::size_t failures = failed_checks();
+
+	std::atomic<int> calls{ 0 };
+	Graph			 graph(4);
+	auto			 a		= graph.add(counted_constant(1, calls));
+	auto			 b		= graph.add(counted_constant(2, calls));
+	auto			 unused = graph.add(counted_constant(3, calls));
+	auto			 sum	= graph.add(counted_sum(calls), { a, b });
+
+	graph.evaluate(sum);
+	EXPECT_TRUE(graph.is_ok(sum) && graph.get(sum) == 3);
+	EXPECT_TRUE(!graph.is_evaluated(unused));
+	EXPECT_TRUE(calls == 3);
+	PrintResult("ThunkGraph evaluates only demanded nodes:", failures);
+}
+
+void check_ThunkGraph_memoizes_results(void)
+{
+	std::size_t failures = failed_checks();
+
+	std::atomic<int> calls{ 0 };
+	Graph			 graph(2);
+	auto			 a	  = graph.add(counted_constant(5, calls));
+	auto			 b	  = graph.add(counted_sum(calls), { a });
+	auto			 c	  = graph.add(counted_sum(calls), { a, b });
+	auto			 root = graph.add(counted_sum(calls), { b, c });
+
+	graph.evaluate(b);
+	EXPECT_TRUE(calls == 2);
+	graph.evaluate({ root, c });
+	EXPECT_TRUE(calls == 4);
+	EXPECT_TRUE(graph.get(root) == 15);
+	graph.evaluate(root);
+	EXPECT_TRUE(calls == 4);
+	PrintResult("ThunkGraph memoizes results:", failures);
+}
+
+void check_ThunkGraph_stops_dependents_of_errors(void)
+{
+	std::size_t failures = failed_checks();
+
+	std::atomic<int> calls{ 0 };
+	Graph			 graph(4);
+	auto			 good = graph.add(counted_constant(1, calls));
+	auto			 bad  = graph.add([&calls](Graph::ThunkInputs) -> OwningResult<int, std::string> {
+		 ++calls;
+		 return OwningErr<std::string>(std::string("bad input"));
+	 });
+	auto			 mid  = graph.add(counted_sum(calls), { good, bad });
+	auto			 root = graph.add(counted_sum(calls), { mid });
+
+	graph.evaluate(root);
+	EXPECT_TRUE(calls == 2);
+	EXPECT_TRUE(graph.is_ok(good));
+	EXPECT_TRUE(graph.is_err(root) && graph.get_err(root) == "bad input");
+
+	// The error is moved out of the node's result and shared with its dependents, never copied
+	ThunkGraph<int, Tracked> tracked_graph(1);
+	auto failing = tracked_graph.add([](auto) -> OwningResult<int, Tracked> {
+		return OwningErr<Tracked>(Tracked(5));
+	});
+	auto dependent = tracked_graph.add([](auto) -> OwningResult<int, Tracked> {
+		return OwningOk<int>(0);
+	}, { failing });
+	EXPECT_COPIES(0, tracked_graph.evaluate(dependent));
+	EXPECT_TRUE(tracked_graph.get_err(dependent).value() == 5);
+	PrintResult("ThunkGraph stops dependents of errors:", failures);
+}
+
+void check_ThunkGraph_rethrows_exceptions_of_thunks(void)
+{
+	std::size_t failures = failed_checks();
+
+	std::atomic<int> calls{ 0 };
+	bool			 fail = true;
+
+	Graph::ThunkFunction throws_until_fixed = [&calls, &fail](Graph::ThunkInputs) {
+		++calls;
+		if (fail) throw std::runtime_error("flaky");
+		return OwningResult<int, std::string>(OwningOk<int>(2));
+	};
+
+	Graph graph(2);
+	auto  good	= graph.add(counted_constant(1, calls));
+	auto  flaky = graph.add(std::move(throws_until_fixed));
+	auto  root	= graph.add(counted_sum(calls), { good, flaky });
+
+	// The exception does not reach the worker thread, evaluate rethrows it
+	bool thrown = false;
+	try
+	{
+		graph.evaluate(root);
+	}
+	catch (const std::runtime_error& error)
+	{
+		thrown = std::string(error.what()) == "flaky";
+	}
+	EXPECT_TRUE(thrown && calls == 2);
+	EXPECT_TRUE(graph.is_ok(good));
+	EXPECT_TRUE(!graph.is_evaluated(flaky) && !graph.is_evaluated(root));
+
+	// Nodes that threw are not memoized and run again
+	fail = false;
+	graph.evaluate(root);
+	EXPECT_TRUE(calls == 4 && graph.get(root) == 3);
+	PrintResult("ThunkGraph rethrows exceptions of thunks:", failures);
+}
@@ -0,0 +1,139 @@
+//    Copyright (C) 2022  Liam Clink and Kevin Ingles
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+//    =================================
+//    Author: Kevin Ingles
+//    File: Zip_test.cpp
+//    Description: Checks that zip combines Ok values in order, picks the first error by position
+//                 and that match visits both outcomes
+//    =================================
+
+#include "Zip.hpp"
+#include "instrumentation.hpp"
+
+#include <string>
+#include <tuple>
+
+using IntResult	   = OwningResult<int, std::string>;
+using StringResult = OwningResult<std::string, std::string>;
+using DoubleResult = OwningResult<double, std::string>;
+
+void check_Zip_all_ok(void);
+void check_Zip_first_error(void);
+void check_Zip_match(void);
+
+int main()
+{
+	check_Zip_all_ok();
+	check_Zip_first_error();
+	check_Zip_match();
+	return test_exit_code();
+}
+
+void check_Zip_all_ok(void)
+{
+	std::size_t failures = failed_checks();
+
+	IntResult	 id	  = OwningOk<int>(7);
+	StringResult name = OwningOk<std::string>(std::string("seven"));
+	DoubleResult mass = OwningOk<double>(7.5);
+	EXPECT_TRUE(all_ok(id, name, mass) && first_err_index(id, name, mass) == 3);
+
+	auto zipped = zip(id, name, mass);
+	EXPECT_TRUE(zipped.is_ok());
+	auto [zipped_id, zipped_name, zipped_mass] = zipped.unwrap();
+	EXPECT_TRUE(zipped_id == 7 && zipped_name == "seven" && zipped_mass == 7.5);
+
+	// Values are moved into the tuple: one allocation for its box, the input boxes are freed
+	using TrackedResult = OwningResult<Tracked, int>;
+	TrackedScope tracked;
+	{
+		TrackedResult first	 = OwningOk<Tracked>(Tracked(1));
+		TrackedResult second = OwningOk<Tracked>(Tracked(2));
+		EXPECT_ALLOCS(1, (void)zip(first, second));
+	}
+	EXPECT_TRUE(tracked.copies() == 0 && tracked.alive() == 0);
+
+	// Temporaries work as well
+	auto from_temporaries = zip(IntResult(OwningOk<int>(1)), IntResult(OwningOk<int>(2)));
+	EXPECT_TRUE(from_temporaries.unwrap() == std::make_tuple(1, 2));
+	PrintResult("zip moves all Ok values into a tuple:", failures);
+}
+
+void check_Zip_first_error(void)
+{
+	std::size_t failures = failed_checks();
+
+	IntResult	 id	  = OwningOk<int>(7);
+	StringResult name = OwningErr<std::string>(std::string("no name"));
+	DoubleResult mass = OwningErr<std::string>(std::string("no mass"));
+	EXPECT_TRUE(!all_ok(id, name, mass) && first_err_index(id, name, mass) == 1);
+
+	auto zipped = zip(id, name, mass);
+	EXPECT_TRUE(zipped.is_err() && *zipped.err() == "no name");
+
+	// Only the returned error is consumed, the other results are left untouched
+	EXPECT_TRUE(id.is_ok() && id.unwrap() == 7);
+	EXPECT_TRUE(name.peek_err() == nullptr);
+	EXPECT_TRUE(mass.peek_err() != nullptr && *mass.peek_err() == "no mass");
+
+	IntResult only = OwningErr<std::string>(std::string("single"));
+	EXPECT_TRUE(*zip(only).err() == "single");
+	PrintResult("zip returns the first error by position:", failures);
+}
+
+void check_Zip_match(void)
+{
+	std::size_t failures = failed_checks();
+
+	// Tuple values are unpacked into separate arguments when the Ok handler takes them
+	auto sum = match(
+		zip(IntResult(OwningOk<int>(2)), DoubleResult(OwningOk<double>(0.5))),
+		[](int a, double b) { return static_cast<double>(a) + b; },
+		[](const std::string&) { return -1.0; });
+	EXPECT_TRUE(sum == 2.5);
+
+	// ... and passed whole when the handler takes the tuple, to bind it with a structured binding
+	std::string label = match(
+		zip(IntResult(OwningOk<int>(3)), StringResult(OwningOk<std::string>(std::string("x")))),
+		[](std::tuple<int, std::string>&& fields) {
+			auto [count, name] = std::move(fields);
+			return name + std::to_string(count);
+		},
+		[](std::string&& error) { return error; });
+	EXPECT_TRUE(label == "x3");
+
+	std::string error = match(
+		zip(IntResult(OwningOk<int>(3)), IntResult(OwningErr<std::string>(std::string("bad")))),
+		[](int, int) { return std::string(); },
+		[](std::string&& what) { return what; });
+	EXPECT_TRUE(error == "bad");
+
+	// Plain results and void values
+	auto plain = match(
+		IntResult(OwningOk<int>(4)), [](int v) { return v; }, [](auto&&) { return 0; });
+	EXPECT_TRUE(plain == 4);
+	OwningResult<void, int> status = OwningOk<void>();
+	EXPECT_TRUE(match(status, []() { return true; }, [](int) { return false; }));
+
+	// Without an error type the Err handler takes no arguments
+	using Maybe = OwningResult<int, void>;
+	Maybe some	= 5;
+	Maybe none	= OwningErr<void>();
+	EXPECT_TRUE(match(some, [](int v) { return v; }, []() { return -1; }) == 5);
+	EXPECT_TRUE(match(none, [](int v) { return v; }, []() { return -1; }) == -1);
+	PrintResult("match visits the Ok and the Err outcome:", failures);
+}
@@ -0,0 +1,344 @@
+//  Copyright 2021-2022 Liam Clink and Kevin Ingles
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the right to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Sofware is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial poritions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//  SOFTWARE OR THE USE OF OTHER DEALINGS IN THE SOFTWARE
+//
+//  ==================================
+//  Author: Kevin Ingles
+//  File: instrumentation.hpp
+//  Description: Allocation counting global operator new/delete, copy and move counting payloads
+//               and the EXPECT_* macros that turn them into failing checks
+//  ==================================
+//
+//  The replacement operator new/delete are definitions, not declarations, so this header must be
+//  included by exactly one translation unit of a test executable. Every test is a single .cpp,
+//  which makes that the test itself.
+
+#ifndef OL_INSTRUMENTATION_HPP
+#define OL_INSTRUMENTATION_HPP
+
+#include "test.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace instrumentation
+{
+	struct AllocationCounters {
+		std::atomic<std::size_t> allocations{ 0 };
+		std::atomic<std::size_t> deallocations{ 0 };
+		std::atomic<std::size_t> bytes{ 0 };
+	};
+
+	inline AllocationCounters& allocation_counters(void)
+	{
+		static AllocationCounters counters;
+		return counters;
+	}
+
+	inline void* allocate(std::size_t size, std::size_t alignment, bool nothrow)
+	{
+		// malloc(0) may return nullptr, operator new may not
+		if (size == 0) size = 1;
+		void* ptr = alignment > alignof(std::max_align_t)
+					  ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+					  : std::malloc(size);
+		if (ptr == nullptr)
+		{
+			if (nothrow) return nullptr;
+			throw std::bad_alloc();
+		}
+		AllocationCounters& counters = allocation_counters();
+		counters.allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.bytes.fetch_add(size, std::memory_order_relaxed);
+		return ptr;
+	}
+
+	inline void deallocate(void* ptr) noexcept
+	{
+		if (ptr == nullptr) return;
+		allocation_counters().deallocations.fetch_add(1, std::memory_order_relaxed);
+		std::free(ptr);
+	}
+} // namespace instrumentation
+
+// Replacement allocation functions, every form forwards to the counting pair above
+void* operator new(std::size_t size) { return instrumentation::allocate(size, 0, false); }
+void* operator new[](std::size_t size) { return instrumentation::allocate(size, 0, false); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return instrumentation::allocate(size, 0, true);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return instrumentation::allocate(size, 0, true);
+}
+void* operator new(std::size_t size, std::align_val_t align)
+{
+	return instrumentation::allocate(size, static_cast<std::size_t>(align), false);
+}
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+	return instrumentation::allocate(size, static_cast<std::size_t>(align), false);
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+	return instrumentation::allocate(size, static_cast<std::size_t>(align), true);
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+	return instrumentation::allocate(size, static_cast<std::size_t>(align), true);
+}
+
+void operator delete(void* ptr) noexcept { instrumentation::deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { instrumentation::deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { instrumentation::deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { instrumentation::deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	instrumentation::deallocate(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	instrumentation::deallocate(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept { instrumentation::deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { instrumentation::deallocate(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	instrumentation::deallocate(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	instrumentation::deallocate(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	instrumentation::deallocate(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	instrumentation::deallocate(ptr);
+}
+
+/// Counts the allocations made between its construction and the call of one of its getters.
+/// The counters are process wide, so allocations made by other threads in the meantime count too.
+class AllocationScope
+{
+	public:
+
+	AllocationScope(void) noexcept
+	{
+		const auto& counters = instrumentation::allocation_counters();
+		m_allocations		 = counters.allocations.load(std::memory_order_relaxed);
+		m_deallocations		 = counters.deallocations.load(std::memory_order_relaxed);
+		m_bytes				 = counters.bytes.load(std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] std::size_t allocations(void) const noexcept
+	{
+		return instrumentation::allocation_counters().allocations.load(std::memory_order_relaxed)
+			 - m_allocations;
+	}
+
+	[[nodiscard]] std::size_t deallocations(void) const noexcept
+	{
+		return instrumentation::allocation_counters().deallocations.load(std::memory_order_relaxed)
+			 - m_deallocations;
+	}
+
+	[[nodiscard]] std::size_t bytes(void) const noexcept
+	{
+		return instrumentation::allocation_counters().bytes.load(std::memory_order_relaxed)
+			 - m_bytes;
+	}
+
+	private:
+
+	std::size_t m_allocations;
+	std::size_t m_deallocations;
+	std::size_t m_bytes;
+};
+
+/// Snapshot of the special member calls made on `Tracked` objects
+struct TrackedCounts {
+	std::size_t constructions{ 0 };
+	std::size_t copies{ 0 };
+	std::size_t moves{ 0 };
+	std::size_t destructions{ 0 };
+};
+
+/// Payload that counts how often it is constructed, copied, moved and destroyed.
+/// Counting is not thread safe, use it from a single thread.
+class Tracked
+{
+	public:
+
+	Tracked(void) noexcept : Tracked(0) {}
+
+	explicit Tracked(int value) noexcept : m_value{ value } { ++counts().constructions; }
+
+	Tracked(const Tracked& other) noexcept : m_value{ other.m_value } { ++counts().copies; }
+
+	Tracked(Tracked&& other) noexcept : m_value{ other.m_value }
+	{
+		other.m_value = moved_from;
+		++counts().moves;
+	}
+
+	Tracked& operator=(const Tracked& other) noexcept
+	{
+		m_value = other.m_value;
+		++counts().copies;
+		return *this;
+	}
+
+	Tracked& operator=(Tracked&& other) noexcept
+	{
+		m_value		  = other.m_value;
+		other.m_value = moved_from;
+		++counts().moves;
+		return *this;
+	}
+
+	~Tracked(void) noexcept { ++counts().destructions; }
+
+	[[nodiscard]] int value(void) const noexcept { return m_value; }
+
+	bool operator==(const Tracked& other) const noexcept { return m_value == other.m_value; }
+
+	static TrackedCounts& counts(void) noexcept
+	{
+		static TrackedCounts counts;
+		return counts;
+	}
+
+	static constexpr int moved_from = -1;
+
+	private:
+
+	int m_value;
+};
+
+/// Counts the `Tracked` special member calls made between its construction and a getter call
+class TrackedScope
+{
+	public:
+
+	TrackedScope(void) noexcept : m_start{ Tracked::counts() } {}
+
+	[[nodiscard]] std::size_t copies(void) const noexcept
+	{
+		return Tracked::counts().copies - m_start.copies;
+	}
+
+	[[nodiscard]] std::size_t moves(void) const noexcept
+	{
+		return Tracked::counts().moves - m_start.moves;
+	}
+
+	/// Constructions that were neither copies nor moves
+	[[nodiscard]] std::size_t constructions(void) const noexcept
+	{
+		return Tracked::counts().constructions - m_start.constructions;
+	}
+
+	/// Constructed minus destroyed, zero when nothing leaked
+	[[nodiscard]] long alive(void) const noexcept
+	{
+		const TrackedCounts& now		= Tracked::counts();
+		std::size_t			 created	= now.constructions + now.copies + now.moves;
+		std::size_t			 created_0	= m_start.constructions + m_start.copies + m_start.moves;
+		std::size_t			 destroyed	= now.destructions - m_start.destructions;
+		return static_cast<long>(created - created_0) - static_cast<long>(destroyed);
+	}
+
+	private:
+
+	TrackedCounts m_start;
+};
+
+namespace instrumentation
+{
+	inline bool expect_count(const char*  what,
+							 const char*  expression,
+							 std::size_t  expected,
+							 std::size_t  actual,
+							 const char*  file,
+							 int		  line)
+	{
+		if (expected == actual) return true;
+		++failed_checks();
+		std::cerr << file << ":" << line << ": expected " << expected << " " << what << " in `"
+				  << expression << "`, got " << actual << "\n";
+		return false;
+	}
+} // namespace instrumentation
+
+// `expr` runs in its own scope, names it declares are not visible after the check
+
+/// Fails the current test unless evaluating `expr` makes exactly `n` heap allocations
+#define EXPECT_ALLOCS(n, expr)                                                                    \
+	do {                                                                                          \
+		AllocationScope expect_scope_;                                                            \
+		{                                                                                         \
+			expr;                                                                                 \
+		}                                                                                         \
+		instrumentation::expect_count(                                                            \
+			"allocations", #expr, (n), expect_scope_.allocations(), __FILE__, __LINE__);          \
+	} while (false)
+
+/// Fails the current test unless `expr` allocates and frees exactly `n` times, i.e. does not leak
+#define EXPECT_ALLOCS_BALANCED(n, expr)                                                           \
+	do {                                                                                          \
+		AllocationScope expect_scope_;                                                            \
+		{                                                                                         \
+			expr;                                                                                 \
+		}                                                                                         \
+		instrumentation::expect_count(                                                            \
+			"allocations", #expr, (n), expect_scope_.allocations(), __FILE__, __LINE__);          \
+		instrumentation::expect_count(                                                            \
+			"deallocations", #expr, (n), expect_scope_.deallocations(), __FILE__, __LINE__);      \
+	} while (false)
+
+/// Fails the current test unless evaluating `expr` copies a `Tracked` exactly `n` times
+#define EXPECT_COPIES(n, expr)                                                                    \
+	do {                                                                                          \
+		TrackedScope expect_scope_;                                                               \
+		{                                                                                         \
+			expr;                                                                                 \
+		}                                                                                         \
+		instrumentation::expect_count(                                                            \
+			"copies", #expr, (n), expect_scope_.copies(), __FILE__, __LINE__);                    \
+	} while (false)
+
+/// Fails the current test unless evaluating `expr` moves a `Tracked` exactly `n` times
+#define EXPECT_MOVES(n, expr)                                                                     \
+	do {                                                                                          \
+		TrackedScope expect_scope_;                                                               \
+		{                                                                                         \
+			expr;                                                                                 \
+		}                                                                                         \
+		instrumentation::expect_count(                                                            \
+			"moves", #expr, (n), expect_scope_.moves(), __FILE__, __LINE__);                      \
+	} while (false)
+
+#endif
@@ -25,6 +25,9 @@
 //  Description: Contains the main preamble to run tests
 //  ==================================
 
+#ifndef OL_TEST_HPP
+#define OL_TEST_HPP
+
 #ifdef __clang__
 #  pragma message("Hello from clang compilation")
 #elif defined(__GNUC__)
@@ -34,6 +37,7 @@
 #define STRINGIFY(x) #x
 #define COMPILE_TIME_PRINT(x) _Pragma(STRINGIFY(message(x)))
 
+#include <cstddef>
 #include <iostream>
 #include <string_view>
 
@@ -65,3 +69,32 @@ constexpr auto type_name(T)
 	name.remove_suffix(suffix.size());
 	return name;
 }
+
+/// Number of failed EXPECT_* checks so far in this test executable
+inline std::size_t& failed_checks(void)
+{
+	static std::size_t count = 0;
+	return count;
+}
+
+/// Prints the verdict of a test function, given the value of `failed_checks()` when it started
+inline void PrintResult(std::string_view name, std::size_t failures_before)
+{
+	if (failed_checks() == failures_before) PrintLn(name, "\033[01;32m[Passed]\033[0m");
+	else PrintLn(name, "\033[01;31m[Failed]\033[0m");
+}
+
+/// What `main` returns, non-zero when any check failed so that `make test_all` stops
+inline int test_exit_code(void) { return failed_checks() == 0 ? 0 : 1; }
+
+/// Fails the current test unless `cond` holds
+#define EXPECT_TRUE(cond)                                                                         \
+	do {                                                                                          \
+		if (!(cond))                                                                              \
+		{                                                                                         \
+			++failed_checks();                                                                    \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": expected `" << #cond << "`\n";         \
+		}                                                                                         \
+	} while (false)
+
+#endif